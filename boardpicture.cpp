@@ -0,0 +1,165 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "boardpicture.h"
+#include <QHash>
+#include <QPainter>
+#include <QPixmapCache>
+#include <QSvgRenderer>
+
+// How long (in ms) the size has to hold still before rendering at it.
+#define RERENDER_DELAY 150
+
+boardPicture::boardPicture(QWidget *parent)
+    : QWidget(parent)
+{
+    rerenderTimer.setSingleShot(true);
+    rerenderTimer.setInterval(RERENDER_DELAY);
+    connect(&rerenderTimer, &QTimer::timeout, this, &boardPicture::Rerender);
+}
+
+
+boardPicture::~boardPicture()
+{
+    // the worker writes straight into this object, so let it finish first.
+    if(renderThread) {
+        renderThread->wait();
+    }
+}
+
+
+void boardPicture::SetPicture(const QString &path)
+{
+    if(path == picture) {
+        return;
+    }
+    picture = path;
+
+    // the SVG only gets parsed here for its size, once per picture.
+    static QHash<QString, QSize> pictureSizes;
+    if(!pictureSizes.contains(path)) {
+        pictureSizes.insert(path, QSvgRenderer(path).defaultSize());
+    }
+    pictureSize = pictureSizes.value(path);
+    lastFrame = QPixmap();
+    updateGeometry();
+    Rerender();
+}
+
+
+QSize boardPicture::sizeHint() const
+{
+    return pictureSize.isValid() ? pictureSize : QWidget::sizeHint();
+}
+
+
+QRect boardPicture::TargetRect() const
+{
+    if(pictureSize.isEmpty()) {
+        return QRect();
+    }
+    QSize size = pictureSize.scaled(this->size(), Qt::KeepAspectRatio);
+    QRect target(QPoint(), size);
+    target.moveCenter(rect().center());
+    return target;
+}
+
+
+QString boardPicture::CacheKey(const QSize &size) const
+{
+    return QString("boardPicture:%1:%2x%3@%4").arg(picture).arg(size.width()).arg(size.height()).arg(devicePixelRatioF());
+}
+
+
+void boardPicture::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    QRect target = TargetRect();
+    if(target.isEmpty()) {
+        return;
+    }
+    QPainter painter(this);
+    QPixmap frame;
+    if(QPixmapCache::find(CacheKey(target.size()), &frame)) {
+        lastFrame = frame;
+        painter.drawPixmap(target.topLeft(), frame);
+    } else if(!lastFrame.isNull()) {
+        // stand-in until the right size is ready.
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+        painter.drawPixmap(target, lastFrame);
+        if(!rerenderTimer.isActive() && !renderThread) {
+            rerenderTimer.start();
+        }
+    } else if(!renderThread) {
+        Rerender();
+    }
+}
+
+
+void boardPicture::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    rerenderTimer.start();
+}
+
+
+void boardPicture::Rerender()
+{
+    QRect target = TargetRect();
+    if(target.isEmpty() || renderThread) {
+        // whatever's in flight will check if it's still the right size when it's done.
+        return;
+    }
+    QString key = CacheKey(target.size());
+    QPixmap cached;
+    if(QPixmapCache::find(key, &cached)) {
+        update();
+        return;
+    }
+
+    qreal ratio = devicePixelRatioF();
+    QSize pixels = target.size() * ratio;
+    QString path = picture;
+    renderKey = key;
+    // QPixmaps are GUI thread only, so the worker draws into a QImage.
+    renderThread = QThread::create([this, path, pixels, ratio]() {
+        QImage image(pixels, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+        image.setDevicePixelRatio(ratio);
+        QSvgRenderer renderer(path);
+        QPainter painter(&image);
+        renderer.render(&painter, QRectF(QPointF(), QSizeF(pixels) / ratio));
+        painter.end();
+        rendered = image;
+    });
+    connect(renderThread, &QThread::finished, this, &boardPicture::renderThread_finished);
+    connect(renderThread, &QThread::finished, renderThread, &QObject::deleteLater);
+    renderThread->start();
+}
+
+
+void boardPicture::renderThread_finished()
+{
+    QPixmapCache::insert(renderKey, QPixmap::fromImage(rendered));
+    rendered = QImage();
+    renderThread = nullptr;
+    // if the size or picture moved on while rendering, go again.
+    if(!TargetRect().isEmpty() && CacheKey(TargetRect().size()) != renderKey) {
+        Rerender();
+    }
+    update();
+}
@@ -0,0 +1,76 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef BOARDPICTURE_H
+#define BOARDPICTURE_H
+
+#include <QImage>
+#include <QPixmap>
+#include <QPointer>
+#include <QThread>
+#include <QTimer>
+#include <QWidget>
+
+// Board picture for the pins view.
+// The SVG gets rasterized once per board/size/pixel ratio (in the background) and kept in
+// QPixmapCache, so painting is just a blit. While the window's being resized, the last
+// render gets stretched into place and the exact size is only rendered once things settle.
+class boardPicture : public QWidget
+{
+    Q_OBJECT
+
+public:
+    boardPicture(QWidget *parent = nullptr);
+    ~boardPicture();
+
+    // Resource path of the SVG to show.
+    void SetPicture(const QString &path);
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+    void resizeEvent(QResizeEvent *event) override;
+
+private slots:
+    void renderThread_finished();
+
+private:
+    QString picture;
+    // the SVG's own size, for keeping its aspect ratio.
+    QSize pictureSize;
+
+    // last render that fit, used as a stand-in until the current size is cached.
+    QPixmap lastFrame;
+
+    // debounces rerenders while resizing.
+    QTimer rerenderTimer;
+
+    QPointer<QThread> renderThread;
+    QString renderKey;
+    QImage rendered;
+
+    // Where the picture goes in the widget, keeping its aspect ratio.
+    QRect TargetRect() const;
+
+    QString CacheKey(const QSize &size) const;
+
+    void Rerender();
+};
+
+#endif // BOARDPICTURE_H
@@ -0,0 +1,161 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "configdiff.h"
+#include <QHash>
+
+static const char *const profileFieldsNames[profileFieldsCount] = {
+    "topOffset",
+    "bottomOffset",
+    "leftOffset",
+    "rightOffset",
+    "TLled",
+    "TRled",
+    "irSensitivity",
+    "runMode",
+    "layoutType",
+    "color",
+    "name"
+};
+
+packedConfig_s configDiff::Pack(const bool *boolSettings,
+                                const int8_t *inputsMap,
+                                const uint32_t *settingsTable,
+                                const tinyUSBtable_s &tinyUSB,
+                                uint8_t selectedProfile,
+                                const QVector<profilesTable_s> &profiles)
+{
+    packedConfig_s packed;
+    uint32_t *words = packed.words;
+    for(uint8_t i = 0; i < boolTypesCount; i++) {
+        words[packedBools + i] = boolSettings[i];
+    }
+    for(uint8_t i = 0; i < boardInputsCount-1; i++) {
+        words[packedPins + i] = uint8_t(inputsMap[i]);
+    }
+    for(uint8_t i = 0; i < settingsTypesCount; i++) {
+        words[packedSettings + i] = settingsTable[i];
+    }
+    words[packedTinyUSBid] = uint32_t(qHash(tinyUSB.tinyUSBid));
+    words[packedTinyUSBname] = uint32_t(qHash(tinyUSB.tinyUSBname));
+    packed.tinyUSBid = tinyUSB.tinyUSBid;
+    packed.tinyUSBname = tinyUSB.tinyUSBname;
+    words[packedSelectedProfile] = selectedProfile;
+    for(int i = 0; i < profiles.length() && i < PROFILES_MAX; i++) {
+        uint32_t *prof = words + packedProfiles + i * profileFieldsCount;
+        prof[profTopOffset] = profiles[i].topOffset;
+        prof[profBottomOffset] = profiles[i].bottomOffset;
+        prof[profLeftOffset] = profiles[i].leftOffset;
+        prof[profRightOffset] = profiles[i].rightOffset;
+        prof[profTLled] = profiles[i].TLled;
+        prof[profTRled] = profiles[i].TRled;
+        prof[profIrSensitivity] = profiles[i].irSensitivity;
+        prof[profRunMode] = profiles[i].runMode;
+        prof[profLayoutType] = profiles[i].layoutType;
+        prof[profColor] = profiles[i].color;
+        prof[profName] = uint32_t(qHash(profiles[i].profName));
+        packed.profNames[i] = profiles[i].profName;
+    }
+    return packed;
+}
+
+configDiff_t configDiff::Compare(const packedConfig_s &a, const packedConfig_s &b)
+{
+    // Branchless over the whole record so the compiler can vectorize it,
+    // then only walk the words that actually differ.
+    uint32_t differs[PACKED_WORDS_COUNT];
+    for(uint16_t i = 0; i < PACKED_WORDS_COUNT; i++) {
+        differs[i] = a.words[i] ^ b.words[i];
+    }
+    configDiff_t diff;
+    for(uint16_t i = 0; i < packedFieldsCount; i++) {
+        if(differs[i]) {
+            diff.set(i);
+        }
+    }
+    // equal hashes are only nearly always equal strings; the few string fields get checked for real.
+    if(!differs[packedTinyUSBid] && a.tinyUSBid != b.tinyUSBid) {
+        diff.set(packedTinyUSBid);
+    }
+    if(!differs[packedTinyUSBname] && a.tinyUSBname != b.tinyUSBname) {
+        diff.set(packedTinyUSBname);
+    }
+    for(uint8_t i = 0; i < PROFILES_MAX; i++) {
+        uint16_t field = packedProfiles + i * profileFieldsCount + profName;
+        if(!differs[field] && a.profNames[i] != b.profNames[i]) {
+            diff.set(field);
+        }
+    }
+    return diff;
+}
+
+QVector<configDiff_t> configDiff::CompareMany(const packedConfig_s &reference, const QVector<packedConfig_s> &configs)
+{
+    QVector<configDiff_t> diffs(configs.length());
+    for(int i = 0; i < configs.length(); i++) {
+        diffs[i] = Compare(reference, configs[i]);
+    }
+    return diffs;
+}
+
+configDiff_t configDiff::PinsMask()
+{
+    configDiff_t mask;
+    for(uint8_t i = 0; i < boardInputsCount-1; i++) {
+        mask.set(packedPins + i);
+    }
+    return mask;
+}
+
+configDiff_t configDiff::UnitMask()
+{
+    configDiff_t mask;
+    mask.set(packedTinyUSBid);
+    mask.set(packedTinyUSBname);
+    mask.set(packedSelectedProfile);
+    for(uint8_t i = 0; i < PROFILES_MAX; i++) {
+        uint16_t prof = packedProfiles + i * profileFieldsCount;
+        mask.set(prof + profTopOffset);
+        mask.set(prof + profBottomOffset);
+        mask.set(prof + profLeftOffset);
+        mask.set(prof + profRightOffset);
+        mask.set(prof + profTLled);
+        mask.set(prof + profTRled);
+    }
+    return mask;
+}
+
+QString configDiff::FieldName(uint16_t field)
+{
+    if(field < packedPins) {
+        return QString("toggles.%1").arg(boolTypesNames[field - packedBools]);
+    } else if(field < packedSettings) {
+        return QString("pins.%1").arg(boardInputsNames[field - packedPins + 1]);
+    } else if(field < packedTinyUSBid) {
+        return QString("settings.%1").arg(settingsSchema[field - packedSettings].name);
+    } else if(field == packedTinyUSBid) {
+        return "tinyUSB.id";
+    } else if(field == packedTinyUSBname) {
+        return "tinyUSB.name";
+    } else if(field == packedSelectedProfile) {
+        return "selectedProfile";
+    } else if(field < packedFieldsCount) {
+        uint16_t offset = field - packedProfiles;
+        return QString("profiles.%1.%2").arg(offset / profileFieldsCount + 1).arg(profileFieldsNames[offset % profileFieldsCount]);
+    }
+    return QString();
+}
@@ -0,0 +1,98 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CONFIGDIFF_H
+#define CONFIGDIFF_H
+
+#include "constants.h"
+#include <bitset>
+
+// Structural diff engine for whole gun configs.
+// A config gets packed into a flat record of 32-bit words, one per field, so comparing
+// two configs (or hundreds against one) is a straight word-by-word compare over plain arrays.
+
+enum profileFields_e {
+    profTopOffset = 0,
+    profBottomOffset,
+    profLeftOffset,
+    profRightOffset,
+    profTLled,
+    profTRled,
+    profIrSensitivity,
+    profRunMode,
+    profLayoutType,
+    profColor,
+    profName,
+    profileFieldsCount
+};
+
+// Word index of every field in a packed record.
+enum packedFields_e {
+    packedBools = 0,
+    packedPins = packedBools + boolTypesCount,
+    packedSettings = packedPins + boardInputsCount-1,
+    packedTinyUSBid = packedSettings + settingsTypesCount,
+    packedTinyUSBname,
+    packedSelectedProfile,
+    packedProfiles,
+    // room for the most profiles any gun has; ones past the end of a config pack as zeroes.
+    packedFieldsCount = packedProfiles + PROFILES_MAX * profileFieldsCount
+};
+
+// rounded up so the compare loop doesn't need a scalar tail.
+#define PACKED_WORDS_COUNT ((packedFieldsCount + 7) & ~7)
+
+typedef struct packedConfig_t {
+    uint32_t words[PACKED_WORDS_COUNT] = {};
+    // the strings behind the hashed words, to rule out a collision hiding a real change.
+    QString tinyUSBid;
+    QString tinyUSBname;
+    QString profNames[PROFILES_MAX];
+} packedConfig_s;
+
+// One bit per packed field, set where two configs differ.
+typedef std::bitset<packedFieldsCount> configDiff_t;
+
+namespace configDiff {
+
+// Strings (TinyUSB ID & name, profile names) are packed as a hash of their contents, and kept alongside
+// so Compare() can double check the ones whose hashes match.
+packedConfig_s Pack(const bool *boolSettings,
+                    const int8_t *inputsMap,
+                    const uint32_t *settingsTable,
+                    const tinyUSBtable_s &tinyUSB,
+                    uint8_t selectedProfile,
+                    const QVector<profilesTable_s> &profiles);
+
+configDiff_t Compare(const packedConfig_s &a, const packedConfig_s &b);
+
+// Every config against one reference, e.g. a whole fleet against its golden config.
+QVector<configDiff_t> CompareMany(const packedConfig_s &reference, const QVector<packedConfig_s> &configs);
+
+// Mask covering the pins range, for when custom pins are off and the map doesn't count.
+configDiff_t PinsMask();
+
+// Mask covering what's meant to differ from gun to gun (calibration, TinyUSB identity, active profile),
+// for when a fleet's compared against one golden config.
+configDiff_t UnitMask();
+
+// e.g. "toggles.rumble", "pins.trigger", "settings.rumbleStrength", "profiles.2.color"
+QString FieldName(uint16_t field);
+
+}
+
+#endif // CONFIGDIFF_H
@@ -0,0 +1,128 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "confighistory.h"
+
+// Most steps kept; the oldest ones go first.
+#define HISTORY_MAX 500
+
+// Edits to the same field closer together than this (in ms) are one step.
+#define HISTORY_MERGE_TIME 1000
+
+static bool ProfilesEqual(const QVector<profilesTable_s> &a, const QVector<profilesTable_s> &b)
+{
+    if(a.length() != b.length()) {
+        return false;
+    }
+    for(int i = 0; i < a.length(); i++) {
+        if(a[i].topOffset != b[i].topOffset || a[i].bottomOffset != b[i].bottomOffset ||
+           a[i].leftOffset != b[i].leftOffset || a[i].rightOffset != b[i].rightOffset ||
+           a[i].TLled != b[i].TLled || a[i].TRled != b[i].TRled ||
+           a[i].irSensitivity != b[i].irSensitivity || a[i].runMode != b[i].runMode ||
+           a[i].layoutType != b[i].layoutType || a[i].color != b[i].color ||
+           a[i].profName != b[i].profName) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Points table at previous's copy if they hold the same thing. True if it did.
+template<typename T>
+static bool Share(QSharedPointer<const T> &table, const QSharedPointer<const T> &previous)
+{
+    if(table == previous || (table && previous && *table == *previous)) {
+        table = previous;
+        return true;
+    }
+    return false;
+}
+
+void configHistory::Clear()
+{
+    states.clear();
+    current = -1;
+    lastField = -1;
+}
+
+
+bool configHistory::Record(configState_s state, int field)
+{
+    if(current >= 0) {
+        const configState_s &previous = states[current];
+        bool same = Share(state.bools, previous.bools);
+        same &= Share(state.pins, previous.pins);
+        same &= Share(state.settings, previous.settings);
+        if(state.tinyUSB && previous.tinyUSB &&
+           state.tinyUSB->tinyUSBid == previous.tinyUSB->tinyUSBid &&
+           state.tinyUSB->tinyUSBname == previous.tinyUSB->tinyUSBname) {
+            state.tinyUSB = previous.tinyUSB;
+        } else {
+            same = false;
+        }
+        if(ProfilesEqual(state.profiles, previous.profiles)) {
+            state.profiles = previous.profiles;
+        } else {
+            same = false;
+        }
+        same &= state.selectedProfile == previous.selectedProfile;
+        if(same) {
+            return false;
+        }
+    }
+
+    states.resize(current + 1);
+    // the starting point never gets merged into, so there's always that to go back to.
+    if(field >= 0 && field == lastField && current > 0 && lastRecord.isValid() && lastRecord.elapsed() < HISTORY_MERGE_TIME) {
+        states[current] = state;
+    } else {
+        states.append(state);
+        if(states.length() > HISTORY_MAX) {
+            states.removeFirst();
+        }
+        current = states.length() - 1;
+    }
+    lastField = field;
+    lastRecord.start();
+    return true;
+}
+
+
+bool configHistory::CanUndo() const
+{
+    return current > 0;
+}
+
+
+bool configHistory::CanRedo() const
+{
+    return current >= 0 && current < states.length() - 1;
+}
+
+
+const configState_s &configHistory::Undo()
+{
+    lastField = -1;
+    return states[--current];
+}
+
+
+const configState_s &configHistory::Redo()
+{
+    lastField = -1;
+    return states[++current];
+}
@@ -0,0 +1,71 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CONFIGHISTORY_H
+#define CONFIGHISTORY_H
+
+#include "constants.h"
+#include <QElapsedTimer>
+#include <QSharedPointer>
+#include <QVector>
+#include <array>
+
+// One whole working config, as it stood after an edit.
+// Tables are shared with neighbouring states that have the same one,
+// so a long history only costs whatever actually changed from step to step.
+typedef struct configState_t {
+    QSharedPointer<const std::array<bool, boolTypesCount>> bools;
+    QSharedPointer<const std::array<int8_t, boardInputsCount-1>> pins;
+    QSharedPointer<const std::array<uint32_t, settingsTypesCount>> settings;
+    QSharedPointer<const tinyUSBtable_s> tinyUSB;
+    // QVector's already implicitly shared, so this one only needs pointing at the same data.
+    QVector<profilesTable_s> profiles;
+    uint8_t selectedProfile = 0;
+} configState_s;
+
+// Linear undo/redo over configState_s, oldest first.
+class configHistory
+{
+public:
+    // Forgets everything; whatever gets recorded next is the new starting point.
+    void Clear();
+
+    // Adds state after the current one, dropping anything that could've been redone.
+    // A quick run of edits to the same field (field being a packed field, see configdiff.h),
+    // like dragging a spinbox, counts as one step; field < 0 never merges.
+    // Returns false if state is no different from the current one.
+    bool Record(configState_s state, int field);
+
+    bool CanUndo() const;
+
+    bool CanRedo() const;
+
+    // Steps back/forward and returns the state to put up. Check CanUndo()/CanRedo() first.
+    const configState_s &Undo();
+
+    const configState_s &Redo();
+
+private:
+    QVector<configState_s> states;
+    int current = -1;
+
+    // for merging runs of edits
+    int lastField = -1;
+    QElapsedTimer lastRecord;
+};
+
+#endif // CONFIGHISTORY_H
@@ -0,0 +1,347 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "configstore.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QMultiHash>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <QtDebug>
+#include <QtEndian>
+#include <algorithm>
+
+// Version of the index's own records; bump whenever storeEntry_s's stored layout changes.
+#define STORE_INDEX_VERSION 2
+
+// Fixed, so hashes come out the same whichever Qt the app was built with.
+#define STORE_STREAM_VERSION QDataStream::Qt_5_15
+
+typedef struct storeIndex_t {
+    bool loaded = false;
+    // bytes of the index file that hold whole records; anything after is a torn write, cut off before the next append.
+    qint64 size = 0;
+    // in the order they were recorded
+    QVector<storeEntry_s> entries;
+    // values are positions in entries
+    QMultiHash<QString, int> bySerial;
+    QMultiHash<QString, int> byBoard;
+    QMultiHash<QByteArray, int> byPins;
+} storeIndex_s;
+
+static storeIndex_s storeIndex;
+
+static QString StorePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/configs";
+}
+
+static QByteArray PinsHash(const int8_t *pins)
+{
+    return QCryptographicHash::hash(QByteArray(reinterpret_cast<const char*>(pins), boardInputsCount-1),
+                                    QCryptographicHash::Sha1).toHex();
+}
+
+static void IndexAdd(const storeEntry_s &entry)
+{
+    int position = storeIndex.entries.length();
+    storeIndex.entries.append(entry);
+    storeIndex.bySerial.insert(entry.serialNumber, position);
+    storeIndex.byBoard.insert(entry.boardName, position);
+    if(!entry.pinsHash.isEmpty()) {
+        storeIndex.byPins.insert(entry.pinsHash, position);
+    }
+}
+
+static void IndexLoad()
+{
+    if(storeIndex.loaded) {
+        return;
+    }
+    storeIndex.loaded = true;
+    QFile file(StorePath() + "/index");
+    if(!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    // Records are length-prefixed, so one that doesn't make sense is skipped over whole,
+    // and only one that runs past the end (cut short by a crash) stops the read.
+    const QByteArray data = file.readAll();
+    qint64 offset = 0;
+    while(data.length() - offset >= qint64(sizeof(quint32))) {
+        quint32 length = qFromBigEndian<quint32>(data.constData() + offset);
+        if(data.length() - offset - qint64(sizeof(quint32)) < length) {
+            break;
+        }
+        QDataStream in(data.mid(offset + sizeof(quint32), length));
+        in.setVersion(STORE_STREAM_VERSION);
+        offset += sizeof(quint32) + length;
+
+        quint8 version, reason;
+        storeEntry_s entry;
+        in >> version >> entry.hash >> entry.serialNumber >> entry.boardName >> entry.timestamp >> reason >> entry.pinsHash;
+        if(in.status() != QDataStream::Ok || version != STORE_INDEX_VERSION || reason > storeCalibrated) {
+            qDebug() << "Skipping a damaged record in the config store index";
+            continue;
+        }
+        entry.boardType = entry.boardName.isEmpty() ? uint8_t(nothing) : BoardTypeFromName(entry.boardName);
+        entry.reason = reason;
+        IndexAdd(entry);
+    }
+    storeIndex.size = offset;
+}
+
+// positions come out of QMultiHash newest first, so flip them back.
+static QVector<storeEntry_s> Entries(QList<int> positions)
+{
+    std::sort(positions.begin(), positions.end());
+    QVector<storeEntry_s> entries;
+    entries.reserve(positions.length());
+    for(int position : std::as_const(positions)) {
+        entries.append(storeIndex.entries[position]);
+    }
+    return entries;
+}
+
+bool configStore::Record(const gunConfig_s &config, const QString &serialNumber, uint8_t reason)
+{
+    IndexLoad();
+    if(!QDir().mkpath(StorePath())) {
+        qDebug() << "Couldn't make config store at" << StorePath();
+        return false;
+    }
+
+    QByteArray blob;
+    QDataStream out(&blob, QIODevice::WriteOnly);
+    out.setVersion(STORE_STREAM_VERSION);
+    out << config;
+
+    storeEntry_s entry;
+    entry.hash = QCryptographicHash::hash(blob, QCryptographicHash::Sha256).toHex();
+    entry.serialNumber = serialNumber;
+    entry.boardName = config.boardName;
+    entry.boardType = config.board.type;
+    entry.timestamp = QDateTime::currentMSecsSinceEpoch();
+    entry.reason = reason;
+    if(config.boolSettings[customPins]) {
+        entry.pinsHash = PinsHash(config.inputsMap.data());
+    }
+
+    // same content, same file; only the index needs to hear about it again.
+    // Written whole or not at all, since one that's there is never written again.
+    QString blobPath = StorePath() + "/" + entry.hash;
+    if(!QFile::exists(blobPath)) {
+        QSaveFile blobFile(blobPath);
+        if(!blobFile.open(QIODevice::WriteOnly) || blobFile.write(blob) != blob.length() || !blobFile.commit()) {
+            qDebug() << "Couldn't write config" << entry.hash << "to the store";
+            return false;
+        }
+    }
+
+    QByteArray record;
+    QDataStream recordOut(&record, QIODevice::WriteOnly);
+    recordOut.setVersion(STORE_STREAM_VERSION);
+    recordOut << quint8(STORE_INDEX_VERSION) << entry.hash << entry.serialNumber << entry.boardName
+              << entry.timestamp << quint8(entry.reason) << entry.pinsHash;
+    QByteArray length(sizeof(quint32), 0);
+    qToBigEndian<quint32>(record.length(), length.data());
+    record.prepend(length);
+
+    QFile indexFile(StorePath() + "/index");
+    // a torn record at the end would throw off every one after it, so it goes before anything's added.
+    if(!indexFile.open(QIODevice::ReadWrite) || (indexFile.size() != storeIndex.size && !indexFile.resize(storeIndex.size)) ||
+       !indexFile.seek(storeIndex.size)) {
+        qDebug() << "Couldn't append to config store index";
+        return false;
+    }
+    if(indexFile.write(record) != record.length() || !indexFile.flush()) {
+        qDebug() << "Couldn't append to config store index";
+        return false;
+    }
+    storeIndex.size += record.length();
+    IndexAdd(entry);
+    return true;
+}
+
+QVector<storeEntry_s> configStore::History(const QString &serialNumber)
+{
+    IndexLoad();
+    return Entries(storeIndex.bySerial.values(serialNumber));
+}
+
+bool configStore::At(const QString &serialNumber, qint64 timestamp, storeEntry_s &entry)
+{
+    IndexLoad();
+    bool found = false;
+    for(int position : storeIndex.bySerial.values(serialNumber)) {
+        const storeEntry_s &candidate = storeIndex.entries[position];
+        if(candidate.timestamp <= timestamp && (!found || candidate.timestamp >= entry.timestamp)) {
+            entry = candidate;
+            found = true;
+        }
+    }
+    return found;
+}
+
+QVector<storeEntry_s> configStore::WithBoard(const QString &boardName)
+{
+    IndexLoad();
+    return Entries(storeIndex.byBoard.values(boardName));
+}
+
+QVector<storeEntry_s> configStore::WithPins(const int8_t *pins)
+{
+    IndexLoad();
+    return Entries(storeIndex.byPins.values(PinsHash(pins)));
+}
+
+gunConfigRef configStore::Load(const QByteArray &hash)
+{
+    QFile file(StorePath() + "/" + hash);
+    if(!file.open(QIODevice::ReadOnly)) {
+        return gunConfigRef();
+    }
+    QByteArray blob = file.readAll();
+    if(QCryptographicHash::hash(blob, QCryptographicHash::Sha256).toHex() != hash) {
+        qDebug() << "Config" << hash << "in the store is damaged";
+        return gunConfigRef();
+    }
+    QDataStream in(blob);
+    in.setVersion(STORE_STREAM_VERSION);
+    gunConfig_s *config = new gunConfig_s;
+    in >> *config;
+    if(in.status() != QDataStream::Ok) {
+        delete config;
+        return gunConfigRef();
+    }
+    return gunConfigRef(config);
+}
+
+QVector<QPair<qint64, profilesTable_s>> configStore::Calibrations(const QString &serialNumber, uint8_t slot)
+{
+    QVector<QPair<qint64, profilesTable_s>> calibrations;
+    QByteArray lastHash;
+    for(const storeEntry_s &entry : History(serialNumber)) {
+        // the same config twice in a row can't have a different calibration.
+        if(entry.hash == lastHash) {
+            continue;
+        }
+        lastHash = entry.hash;
+        gunConfigRef config = Load(entry.hash);
+        if(!config || slot >= config->profiles.length()) {
+            continue;
+        }
+        const profilesTable_s &profile = config->profiles[slot];
+        if(!calibrations.isEmpty()) {
+            const profilesTable_s &last = calibrations.last().second;
+            if(last.topOffset == profile.topOffset && last.bottomOffset == profile.bottomOffset &&
+               last.leftOffset == profile.leftOffset && last.rightOffset == profile.rightOffset &&
+               last.TLled == profile.TLled && last.TRled == profile.TRled) {
+                continue;
+            }
+        }
+        calibrations.append(qMakePair(entry.timestamp, profile));
+    }
+    return calibrations;
+}
+
+static QString EntriesTable(const QVector<storeEntry_s> &entries)
+{
+    const char *reasons[] = { "loaded", "saved", "calibrated" };
+    QString table;
+    QTextStream out(&table);
+    out << QString("%1 %2 %3 %4 %5\n").arg("Time", -20).arg("Serial", -20).arg("Board", -20).arg("Reason", -11).arg("Config");
+    for(const storeEntry_s &entry : entries) {
+        out << QString("%1 %2 %3 %4 %5\n")
+               .arg(QDateTime::fromMSecsSinceEpoch(entry.timestamp).toString("yyyy-MM-dd hh:mm:ss"), -20)
+               .arg(entry.serialNumber, -20)
+               .arg(entry.boardName, -20)
+               .arg(reasons[entry.reason], -11)
+               .arg(QString(entry.hash));
+    }
+    return table;
+}
+
+int configStore::Run(const QStringList &args)
+{
+    QTextStream out(stdout);
+    const QString query = args.value(0);
+    QVector<storeEntry_s> entries;
+
+    if(query == "history" && args.length() > 1) {
+        entries = History(args[1]);
+    } else if(query == "at" && args.length() > 2) {
+        QDateTime time = QDateTime::fromString(args[2], Qt::ISODate);
+        storeEntry_s entry;
+        if(!time.isValid()) {
+            qDebug() << "Couldn't make out a date/time from" << args[2] << "- try e.g. 2024-06-01T18:00";
+            return 1;
+        }
+        if(!At(args[1], time.toMSecsSinceEpoch(), entry)) {
+            out << "Nothing stored for " << args[1] << " as of " << args[2] << "\n";
+            return 1;
+        }
+        out << EntriesTable({entry});
+        if(args.length() > 3) {
+            gunConfigRef config = Load(entry.hash);
+            QString error = "missing or damaged in the store";
+            if(!config || !gunConfig::Export(*config, args[3], error)) {
+                qDebug() << "Couldn't export config" << entry.hash << "-" << error;
+                return 1;
+            }
+            out << "Exported to " << args[3] << "\n";
+        }
+        return 0;
+    } else if(query == "board" && args.length() > 1) {
+        entries = WithBoard(args[1]);
+    } else if(query == "preset" && args.length() > 2) {
+        uint8_t boardType = BoardTypeFromName(args[1]);
+        const boardDesc_s &desc = BoardDesc(boardType);
+        for(uint8_t i = 0; i < desc.presetsCount; i++) {
+            if(args[2].compare(desc.presetsNames[i], Qt::CaseInsensitive) == 0) {
+                // the same map on another board is a different set of pins altogether.
+                for(const storeEntry_s &entry : WithPins(desc.presets[i])) {
+                    if(entry.boardName == desc.fwName) {
+                        entries.append(entry);
+                    }
+                }
+            }
+        }
+    } else if(query == "calibrations" && args.length() > 2) {
+        const auto calibrations = Calibrations(args[1], args[2].toInt() - 1);
+        out << QString("%1 %2 %3 %4 %5 %6 %7\n").arg("Time", -20).arg("Top", -6).arg("Bottom", -6)
+               .arg("Left", -6).arg("Right", -6).arg("TLled", -6).arg("TRled");
+        for(const auto &calibration : calibrations) {
+            const profilesTable_s &profile = calibration.second;
+            out << QString("%1 %2 %3 %4 %5 %6 %7\n")
+                   .arg(QDateTime::fromMSecsSinceEpoch(calibration.first).toString("yyyy-MM-dd hh:mm:ss"), -20)
+                   .arg(profile.topOffset, -6).arg(profile.bottomOffset, -6)
+                   .arg(profile.leftOffset, -6).arg(profile.rightOffset, -6)
+                   .arg(profile.TLled, -6).arg(profile.TRled);
+        }
+        return calibrations.isEmpty() ? 1 : 0;
+    } else {
+        qDebug() << "Unknown or incomplete store query:" << args.join(' ');
+        return 1;
+    }
+
+    out << EntriesTable(entries);
+    out << QString("\n%1 entry(s) found.\n").arg(entries.length());
+    return entries.isEmpty() ? 1 : 0;
+}
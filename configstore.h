@@ -0,0 +1,87 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CONFIGSTORE_H
+#define CONFIGSTORE_H
+
+#include "gunconfig.h"
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+typedef enum {
+    storeLoaded = 0,
+    storeSaved,
+    storeCalibrated
+} storeReasons_e;
+
+// One time a config was seen on a gun.
+typedef struct storeEntry_t {
+    // of the config's binary form (see gunconfig.h), which is also its file name in the store
+    QByteArray hash;
+    // USB serial number of the gun
+    QString serialNumber;
+    // as the firmware reports it (e.g. "rpipico"), which is what's stored
+    QString boardName;
+    // looked up from boardName when the index is read, so it follows boardTypes_e if that's ever reordered
+    uint8_t boardType = nothing;
+    // ms since epoch, UTC
+    qint64 timestamp = 0;
+    uint8_t reason = storeLoaded;
+    // of the custom pin map, or empty if the gun was on its default pins
+    QByteArray pinsHash;
+} storeEntry_s;
+
+// Local history of every config loaded from or saved to a gun, under <AppDataLocation>/configs.
+// Configs are stored once per distinct content, named by their hash; an append-only index
+// says which gun had which one when, and is kept in memory (keyed by gun, board & pin map) once read.
+namespace configStore {
+
+// Returns false if the store couldn't be written to.
+bool Record(const gunConfig_s &config, const QString &serialNumber, uint8_t reason);
+
+// Everything seen on a gun, oldest first.
+QVector<storeEntry_s> History(const QString &serialNumber);
+
+// What a gun had as of a point in time (e.g. yesterday), if anything.
+bool At(const QString &serialNumber, qint64 timestamp, storeEntry_s &entry);
+
+// By firmware name, e.g. "rpipico".
+QVector<storeEntry_s> WithBoard(const QString &boardName);
+
+// Every time any gun was on exactly this pin map (inputsMap layout), e.g. one of a board's presets.
+QVector<storeEntry_s> WithPins(const int8_t *pins);
+
+// null if it's missing or unreadable.
+gunConfigRef Load(const QByteArray &hash);
+
+// A profile's calibration over time on one gun, only where it changed.
+QVector<QPair<qint64, profilesTable_s>> Calibrations(const QString &serialNumber, uint8_t slot);
+
+// --store <query> [args...], with args being everything after --store:
+//   history <serial>                  everything seen on a gun
+//   at <serial> <time> [<file>]       what it had as of an ISO date/time, exported to file if given (see gunConfig::Export)
+//   board <board>                     everything seen on a board type, by firmware name (e.g. rpipico)
+//   preset <board> <preset>           every gun that was on one of a board's pin presets, by name
+//   calibrations <serial> <profile>   a profile's (1-based) calibration over time
+// Prints to stdout, and returns a process exit code: 0 if anything was found, 1 otherwise.
+int Run(const QStringList &args);
+
+}
+
+#endif // CONFIGSTORE_H
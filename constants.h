@@ -20,6 +20,45 @@
 
 #include <QMainWindow>
 
+// How often (in ms) docked guns get poked to check they're still there.
+#define ALIVE_TIMER 5000
+
+// Amount of calibration profiles on guns that don't report how many they have.
+#define PROFILES_COUNT 4
+
+// Most profiles a gun can report; sizes the packed config records (see configdiff.h).
+#define PROFILES_MAX 8
+
+// Longest profile name the firmware keeps.
+#define PROFILE_NAME_MAX 15
+
+// Longest TinyUSB product name the firmware keeps (same as productNameInput's maxLength).
+#define TINYUSB_NAME_MAX 15
+
+// Version of the binary config format (see gunconfig.h); bump whenever its layout changes.
+#define GUNCONFIG_VERSION 1
+
+// First bytes of an exported config file in binary form.
+#define GUNCONFIG_MAGIC "OFcfg"
+
+// Name of the local socket that the background service listens on.
+#define SERVICE_NAME "OpenFIREapp-service"
+
+// How long (ms) a gun has to stay quiet after answering before the service sends it the next request.
+#define SERVICE_QUIET_TIMER 100
+// ...but a gun that never goes quiet (e.g. streaming test output) only holds up the next request this long (ms).
+#define SERVICE_SETTLE_MAX 500
+
+// Name of the service's force feedback relay socket.
+#define FFRELAY_NAME "OpenFIREapp-ffrelay"
+
+// Base name of the local socket used to hand arguments to an already running app.
+#define INSTANCE_NAME "OpenFIREapp-instance"
+
+// How long (ms) to wait on a running app to take a hand-off. Generous, since it may be busy talking to a gun;
+// when there's no app running, connecting fails straight away anyhow.
+#define INSTANCE_TIMEOUT 3000
+
 enum boardTypes_e {
     nothing = 0,
     rpipico,
@@ -99,6 +138,74 @@ enum settingsTypes_e {
     settingsTypesCount
 };
 
+// Field names, for reports & exports. Must match the order of the enums above.
+const char *const boardInputsNames[boardInputsCount] = {
+    "unmapped",
+    "trigger", "buttonA", "buttonB", "buttonC", "start", "select",
+    "up", "down", "left", "right", "pedal", "pedal2",
+    "home", "pump", "rumbleSignal", "solenoidSignal", "rumbleSwitch", "solenoidSwitch",
+    "autofireSwitch", "neoPixel", "ledR", "ledG", "ledB", "camSDA",
+    "camSCL", "periphSDA", "periphSCL", "battery", "analogX", "analogY",
+    "tempSensor"
+};
+
+const char *const boolTypesNames[boolTypesCount] = {
+    "customPins",
+    "rumble",
+    "solenoid",
+    "autofire",
+    "simplePause",
+    "holdToPause",
+    "commonAnode",
+    "lowButtonsMode",
+    "rumbleFF"
+};
+
+enum settingKinds_e {
+    settingNumber = 0,
+    settingColor
+};
+
+// Everything about each tunable setting, in one place. Loading, saving, diffing and
+// the settings tab's widgets all go off of this, so a new setting is a new row here
+// (plus the enum above, and its widget in guiwindow.ui).
+typedef struct settingSchema_t {
+    // wire ID, i.e. its position in "Xls" and the <n> in "Xm.2.<n>.<value>"
+    uint8_t id;
+    // for reports & exports
+    const char *name;
+    uint8_t kind;
+    // anything outside of this gets NOENT from the gun, so it's clamped to it app-side.
+    uint32_t min;
+    uint32_t max;
+    // what the firmware ships with; also used when a gun doesn't report the setting at all.
+    uint32_t def;
+    // object name of the widget it's bound to - a QSpinBox for numbers, a QPushButton for colors.
+    const char *widget;
+} settingSchema_s;
+
+// Indexed by settingsTypes_e.
+constexpr settingSchema_s settingsSchema[settingsTypesCount] = {
+    {rumbleStrength,         "rumbleStrength",         settingNumber, 0, 255,      255,      "rumbleIntensityBox"},
+    {rumbleInterval,         "rumbleInterval",         settingNumber, 0, 9999,     150,      "rumbleLengthBox"},
+    {solenoidNormalInterval, "solenoidNormalInterval", settingNumber, 0, 99,       45,       "solenoidNormalIntervalBox"},
+    {solenoidFastInterval,   "solenoidFastInterval",   settingNumber, 0, 99,       30,       "solenoidFastIntervalBox"},
+    {solenoidHoldLength,     "solenoidHoldLength",     settingNumber, 0, 9999,     500,      "solenoidHoldLengthBox"},
+    {autofireWaitFactor,     "autofireWaitFactor",     settingNumber, 2, 4,        3,        "autofireWaitFactorBox"},
+    {holdToPauseLength,      "holdToPauseLength",      settingNumber, 0, 9999,     2500,     "holdToPauseLengthBox"},
+    {customLEDcount,         "customLEDcount",         settingNumber, 1, 100,      1,        "neopixelStrandLengthBox"},
+    {customLEDstatic,        "customLEDstatic",        settingNumber, 0, 3,        0,        "customLEDstaticSpinbox"},
+    {customLEDcolor1,        "customLEDcolor1",        settingColor,  0, 0xFFFFFF, 0xFF0000, "customLEDstaticBtn1"},
+    {customLEDcolor2,        "customLEDcolor2",        settingColor,  0, 0xFFFFFF, 0x00FF00, "customLEDstaticBtn2"},
+    {customLEDcolor3,        "customLEDcolor3",        settingColor,  0, 0xFFFFFF, 0x0000FF, "customLEDstaticBtn3"}
+};
+
+constexpr uint32_t SettingClamp(uint8_t type, uint32_t value)
+{
+    return value < settingsSchema[type].min ? settingsSchema[type].min :
+           value > settingsSchema[type].max ? settingsSchema[type].max : value;
+}
+
 enum pinTypes_e {
     pinNothing = 0,
     pinDigital,
@@ -110,22 +217,30 @@ enum layoutTypes_e {
     layoutDiamond
 };
 
-const uint8_t boardCustomPresetsCount[presetBoardsCount] = {
-    0, // padding
-    0, // rpipico
-    0, // rpipicow
-    1, // itsybitsy
-    0, // KB2040
-    0, // arduinoNano
-    0, // waveshareZero
-    0, // vccgnd
+// Looks the test screen's labels can take on, each a palette made up once when the screen's built.
+enum testStyles_e {
+    testNormal = 0,
+    testPressed,
+    testCool,
+    testWarm,
+    testHot,
+    testStylesCount
+};
+
+// How much a notice matters, in the same order as PopupWindow's errorType.
+enum notifySeverity_e {
+    notifyPlain = 0,
+    notifyQuestion,
+    notifyInfo,
+    notifyWarning,
+    notifyError
 };
 
-const QStringList rpipicoPresetsList = {
+const char *const rpipicoPresetsNames[] = {
     "EZCon"
 };
 
-const QStringList adafruitItsyBitsyRP2040PresetsList = {
+const char *const adafruitItsyBitsyRP2040PresetsNames[] = {
     "SAMCO 1.1"
 };
 
@@ -138,7 +253,7 @@ const QStringList adafruitItsyBitsyRP2040PresetsList = {
  * Temperature
  */
 
-const int8_t rpipicoPresets[1][boardInputsCount-1] = {
+constexpr int8_t rpipicoPresets[1][boardInputsCount-1] = {
     // name 1: this is currently a placeholder for testing
     {1, -1, -1, -1, -1, -1,
      -1, -1, -1, -1, -1, -1,
@@ -150,7 +265,7 @@ const int8_t rpipicoPresets[1][boardInputsCount-1] = {
     // name 2: subsequent layouts go here
 };
 
-const int8_t adafruitItsyBitsyRP2040Presets[2][boardInputsCount-1] = {
+constexpr int8_t adafruitItsyBitsyRP2040Presets[1][boardInputsCount-1] = {
     // SAMCO 2.0
     /*
     {6, 27, 26, -1, 28, 29,
@@ -176,6 +291,8 @@ typedef struct boardInfo_t {
     QString versionCodename;
     uint8_t selectedProfile;
     uint8_t previousProfile;
+    // as reported in the handshake
+    uint8_t profilesCount = PROFILES_COUNT;
 } boardInfo_s;
 
 typedef struct tinyUSBtable_t {
@@ -202,7 +319,7 @@ typedef struct boardLayout_t {
     uint8_t pinType;
 } boardLayout_s;
 
-const boardLayout_t rpipicoLayout[] = {
+constexpr boardLayout_s rpipicoLayout[30] = {
     {btnGunA, pinDigital},     {btnGunB, pinDigital},
     {btnGunC, pinDigital},     {btnStart, pinDigital},
     {btnSelect, pinDigital},   {btnHome, pinDigital},
@@ -220,7 +337,7 @@ const boardLayout_t rpipicoLayout[] = {
     {btnUnmapped, pinAnalog},  {-2, pinNothing}           // ADC, padding
 };
 
-const boardLayout_t adafruitItsyRP2040Layout[] = {
+constexpr boardLayout_s adafruitItsyRP2040Layout[30] = {
     {btnUnmapped, pinDigital}, {btnUnmapped, pinDigital},
     {camSDA, pinDigital},      {camSCL, pinDigital},
     {btnPedal, pinDigital},    {btnUnmapped, pinDigital},
@@ -238,7 +355,7 @@ const boardLayout_t adafruitItsyRP2040Layout[] = {
     {btnStart, pinAnalog},     {btnSelect, pinAnalog}
 };
 
-const boardLayout_t adafruitKB2040Layout[] = {
+constexpr boardLayout_s adafruitKB2040Layout[30] = {
     {btnUnmapped, pinDigital}, {btnUnmapped, pinDigital},
     {camSDA, pinDigital},      {camSCL, pinDigital},
     {btnGunB, pinDigital},     {rumblePin, pinDigital},
@@ -262,7 +379,7 @@ const boardLayout_t adafruitKB2040Layout[] = {
     {btnTrigger, pinAnalog},   {btnGunA, pinAnalog}
 };
 
-const boardLayout_t arduinoNanoRP2040Layout[] = {
+constexpr boardLayout_s arduinoNanoRP2040Layout[30] = {
     {btnTrigger, pinDigital},  {btnPedal, pinDigital},
     {btnReserved, pinNothing}, {btnReserved, pinNothing},
     {btnGunA, pinDigital},     {btnGunC, pinDigital},
@@ -280,7 +397,7 @@ const boardLayout_t arduinoNanoRP2040Layout[] = {
     {btnUnmapped, pinAnalog},  {btnUnmapped, pinAnalog}
 };
 
-const boardLayout_t waveshareZeroLayout[] = {
+constexpr boardLayout_s waveshareZeroLayout[30] = {
     {btnTrigger, pinDigital},  {btnGunA, pinDigital},
     {btnGunB, pinDigital},     {btnGunC, pinDigital},
     {btnStart, pinDigital},    {btnSelect, pinDigital},
@@ -298,7 +415,7 @@ const boardLayout_t waveshareZeroLayout[] = {
     {btnUnmapped, pinAnalog},  {tempPin, pinAnalog}
 };
 
-const boardLayout_t genericLayout[] = {
+constexpr boardLayout_s genericLayout[30] = {
     {btnUnmapped, pinDigital}, {btnUnmapped, pinDigital},
     {btnUnmapped, pinDigital}, {btnUnmapped, pinDigital},
     {btnUnmapped, pinDigital}, {btnUnmapped, pinDigital},
@@ -316,4 +433,115 @@ const boardLayout_t genericLayout[] = {
     {btnUnmapped, pinAnalog},  {btnUnmapped, pinAnalog}
 };
 
+// Bitmask of the pins in a layout that are of the given type,
+// or that are usable at all if pinType is pinNothing.
+constexpr uint32_t LayoutPinsMask(const boardLayout_s *layout, uint8_t pinType)
+{
+    uint32_t mask = 0;
+    for(uint8_t i = 0; i < 30; i++) {
+        if(pinType == pinNothing ? layout[i].pinType != pinNothing : layout[i].pinType == pinType) {
+            mask |= 1UL << i;
+        }
+    }
+    return mask;
+}
+
+// Bitmask of the boardInputs_e a given pin can be mapped to (bit n = function n).
+// Analog functions need an analog-capable pin; I2C data goes on even pins, clock on odd ones.
+constexpr uint64_t PinFunctionsMask(uint8_t pin, bool analog)
+{
+    uint64_t mask = (1ULL << boardInputsCount) - 1;
+    if(!analog) {
+        mask &= ~((1ULL << analogX) | (1ULL << analogY) | (1ULL << tempPin));
+    }
+    if(pin & 1) {
+        mask &= ~((1ULL << camSDA) | (1ULL << periphSDA));
+    } else {
+        mask &= ~((1ULL << camSCL) | (1ULL << periphSCL));
+    }
+    return mask;
+}
+
+// Everything the app knows about a board, in one place.
+typedef struct boardDesc_t {
+    // as reported in the firmware's handshake
+    const char *fwName;
+    const char *displayName;
+    // resource paths of the board picture, and where the pins go around it (see pinout.h)
+    const char *picture;
+    const char *pinout;
+    // default pin layout, 30 entries (one per GPIO)
+    const boardLayout_s *layout;
+    uint8_t presetsCount;
+    const char *const *presetsNames;
+    const int8_t (*presets)[boardInputsCount-1];
+    // pins that can be mapped to anything at all, and the ADC-capable subset of those
+    uint32_t usablePins;
+    uint32_t analogPins;
+} boardDesc_s;
+
+#define BOARD_DESC(fw, display, pic, pinout, layout, presetsCount, presetsNames, presets) \
+    { fw, display, pic, pinout, layout, presetsCount, presetsNames, presets, \
+      LayoutPinsMask(layout, pinNothing), LayoutPinsMask(layout, pinAnalog) }
+
+// Indexed by boardTypes_e.
+constexpr boardDesc_s boardsTable[presetBoardsCount] = {
+    // nothing
+    BOARD_DESC("", "", ":/boardPics/unknown.svg", ":/pinouts/pico.pinout", genericLayout, 0, nullptr, nullptr),
+    BOARD_DESC("rpipico", "Raspberry Pi Pico", ":/boardPics/pico.svg", ":/pinouts/pico.pinout", rpipicoLayout,
+               0, rpipicoPresetsNames, rpipicoPresets),
+    // pico and w are the same physical board, so why need a new layout for it?
+    BOARD_DESC("rpipicow", "Raspberry Pi Pico W", ":/boardPics/picow.svg", ":/pinouts/pico.pinout", rpipicoLayout,
+               0, rpipicoPresetsNames, rpipicoPresets),
+    BOARD_DESC("adafruitItsyRP2040", "Adafruit ItsyBitsy RP2040", ":/boardPics/adafruitItsy2040.svg", ":/pinouts/adafruitItsy2040.pinout",
+               adafruitItsyRP2040Layout, 1, adafruitItsyBitsyRP2040PresetsNames, adafruitItsyBitsyRP2040Presets),
+    BOARD_DESC("adafruitKB2040", "Adafruit KB2040", ":/boardPics/adafruitKB2040.svg", ":/pinouts/adafruitKB2040.pinout",
+               adafruitKB2040Layout, 0, nullptr, nullptr),
+    BOARD_DESC("arduinoNanoRP2040", "Arduino Nano RP2040 Connect", ":/boardPics/arduinoNano2040.svg", ":/pinouts/arduinoNano2040.pinout",
+               arduinoNanoRP2040Layout, 0, nullptr, nullptr),
+    BOARD_DESC("waveshareZero", "Waveshare RP2040 Zero", ":/boardPics/waveshareZero.svg", ":/pinouts/waveshareZero.pinout",
+               waveshareZeroLayout, 0, nullptr, nullptr),
+    // Pico-compatible pinout, so it borrows its layout & picture.
+    BOARD_DESC("vccgndYD", "VCC-GND YD RP2040", ":/boardPics/pico.svg", ":/pinouts/pico.pinout", rpipicoLayout,
+               0, nullptr, nullptr)
+};
+
+constexpr boardDesc_s genericBoard =
+    BOARD_DESC("", "Generic RP2040 Board", ":/boardPics/unknown.svg", ":/pinouts/pico.pinout", genericLayout, 0, nullptr, nullptr);
+
+#undef BOARD_DESC
+
+constexpr const boardDesc_s &BoardDesc(uint8_t type)
+{
+    return type < presetBoardsCount ? boardsTable[type] : genericBoard;
+}
+
+// FNV-1a, so the firmware's board names can be switched on.
+constexpr uint32_t BoardNameHash(const char *name, uint32_t hash = 2166136261u)
+{
+    return *name ? BoardNameHash(name + 1, (hash ^ uint8_t(*name)) * 16777619u) : hash;
+}
+
+// Board type from the name the firmware reports in its handshake.
+inline uint8_t BoardTypeFromName(const QString &name)
+{
+    const QByteArray fwName = name.toLatin1();
+    uint8_t type = generic;
+    // case labels straight from the table, so two boards hashing the same won't even build.
+    switch(BoardNameHash(fwName.constData())) {
+    case BoardNameHash(boardsTable[rpipico].fwName):            type = rpipico; break;
+    case BoardNameHash(boardsTable[rpipicow].fwName):           type = rpipicow; break;
+    case BoardNameHash(boardsTable[adafruitItsyRP2040].fwName): type = adafruitItsyRP2040; break;
+    case BoardNameHash(boardsTable[adafruitKB2040].fwName):     type = adafruitKB2040; break;
+    case BoardNameHash(boardsTable[arduinoNanoRP2040].fwName):  type = arduinoNanoRP2040; break;
+    case BoardNameHash(boardsTable[waveshareZero].fwName):      type = waveshareZero; break;
+    case BoardNameHash(boardsTable[vccgndYD].fwName):           type = vccgndYD; break;
+    }
+    // and an unknown name that happens to collide with a known one is still unknown.
+    if(type != generic && qstrcmp(fwName.constData(), boardsTable[type].fwName) != 0) {
+        type = generic;
+    }
+    return type;
+}
+
 #endif // CONSTANTS_H
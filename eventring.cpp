@@ -0,0 +1,126 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "eventring.h"
+#include <QtGlobal>
+#include <QtDebug>
+#include <cerrno>
+#include <cstring>
+
+#if !defined(Q_OS_WIN)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#define EVENTRING_SIZE (sizeof(eventRingHeader_s) + EVENTRING_SLOTS * sizeof(eventRecord_s))
+
+eventRing::~eventRing()
+{
+    Close();
+}
+
+bool eventRing::Open()
+{
+#if !defined(Q_OS_WIN)
+    if(header) {
+        return true;
+    }
+    // readable by anyone on the box, only we get to write.
+    int fd = shm_open(EVENTRING_NAME, O_CREAT | O_RDWR, 0644);
+    if(fd < 0) {
+        qDebug() << "Couldn't create event ring" << EVENTRING_NAME << "-" << strerror(errno);
+        return false;
+    }
+    if(ftruncate(fd, EVENTRING_SIZE) < 0) {
+        qDebug() << "Couldn't size event ring -" << strerror(errno);
+        close(fd);
+        return false;
+    }
+    void *map = mmap(nullptr, EVENTRING_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    // the mapping keeps the object alive, the descriptor isn't needed anymore.
+    close(fd);
+    if(map == MAP_FAILED) {
+        qDebug() << "Couldn't map event ring -" << strerror(errno);
+        return false;
+    }
+
+    // Start from a clean slate; readers key off magic, so write that last.
+    memset(map, 0, EVENTRING_SIZE);
+    header = static_cast<eventRingHeader_s*>(map);
+    records = reinterpret_cast<eventRecord_s*>(static_cast<char*>(map) + sizeof(eventRingHeader_s));
+    header->version = EVENTRING_VERSION;
+    header->slotCount = EVENTRING_SLOTS;
+    header->recordSize = sizeof(eventRecord_s);
+    header->writeIndex.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = EVENTRING_MAGIC;
+    qDebug() << "Publishing gun events @" << EVENTRING_NAME;
+    return true;
+#else
+    // No POSIX shared memory here.
+    return false;
+#endif
+}
+
+void eventRing::Close()
+{
+#if !defined(Q_OS_WIN)
+    if(header) {
+        munmap(header, EVENTRING_SIZE);
+        shm_unlink(EVENTRING_NAME);
+        header = nullptr;
+        records = nullptr;
+    }
+#endif
+}
+
+void eventRing::Publish(uint32_t type, uint32_t port, const int32_t *values, uint8_t valuesCount)
+{
+#if !defined(Q_OS_WIN)
+    if(!header) {
+        return;
+    }
+    // Single writer, so nobody else moves writeIndex under us.
+    uint32_t index = header->writeIndex.load(std::memory_order_relaxed);
+    eventRecord_s &record = records[index % EVENTRING_SLOTS];
+
+    record.sequence.store(2*index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    record.type = type;
+    record.timestamp = uint64_t(now.tv_sec) * 1000000000ull + uint64_t(now.tv_nsec);
+    record.port = port;
+    if(valuesCount > 12) {
+        valuesCount = 12;
+    }
+    memcpy(record.values, values, valuesCount * sizeof(int32_t));
+    memset(record.values + valuesCount, 0, (12 - valuesCount) * sizeof(int32_t));
+
+    record.sequence.store(2*index + 2, std::memory_order_release);
+    header->writeIndex.store(index + 1, std::memory_order_release);
+#else
+    Q_UNUSED(type);
+    Q_UNUSED(port);
+    Q_UNUSED(values);
+    Q_UNUSED(valuesCount);
+#endif
+}
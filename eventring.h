@@ -0,0 +1,97 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef EVENTRING_H
+#define EVENTRING_H
+
+#include <atomic>
+#include <cstdint>
+
+// Live gun events, published to a named POSIX shared memory object so overlays,
+// latency loggers and frontends can follow along without touching the serial port.
+//
+// Layout: one eventRingHeader_s, followed by EVENTRING_SLOTS eventRecord_s.
+// Single writer (the app), any number of readers. Record N lives in slot N % EVENTRING_SLOTS.
+// Each slot is a seqlock: the writer stores sequence = 2N+1 before touching the record
+// and 2N+2 once it's done. To read record N: load sequence (acquire), copy the record,
+// load sequence again - the copy is good only if both loads were 2N+2.
+// If the header's writeIndex has gotten more than EVENTRING_SLOTS ahead of you, you've been lapped.
+// Everything is native-endian, since readers are on the same machine.
+
+#define EVENTRING_NAME "/OpenFIREapp-events"
+#define EVENTRING_MAGIC 0x5645464F // "OFEV"
+#define EVENTRING_VERSION 1
+#define EVENTRING_SLOTS 256
+
+enum eventTypes_e {
+    eventNothing = 0,
+    // values[0] = button, numbered as boardInputs_e
+    eventPressed,
+    eventReleased,
+    // values[0] = degrees C
+    eventTemperature,
+    // values[0] = direction, 0 = centered, 1-8 counterclockwise starting from up
+    eventAnalog,
+    // values[0..11] = x,y of top-left, top-right, bottom-left, bottom-right, median & dot points
+    eventIRPoints
+};
+
+typedef struct eventRingHeader_t {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t recordSize;
+    // Total amount of records ever published; the newest is writeIndex-1.
+    std::atomic<uint32_t> writeIndex;
+    uint32_t reserved[11];
+} eventRingHeader_s;
+
+typedef struct eventRecord_t {
+    std::atomic<uint32_t> sequence;
+    uint32_t type;
+    // CLOCK_MONOTONIC, in nanoseconds.
+    uint64_t timestamp;
+    // Index of the gun in the app's port list (1 = first device).
+    uint32_t port;
+    int32_t values[12];
+    uint32_t reserved;
+} eventRecord_s;
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "shared memory needs lock-free atomics");
+static_assert(sizeof(eventRingHeader_s) == 64, "event ring header layout changed");
+static_assert(sizeof(eventRecord_s) == 72, "event ring record layout changed");
+
+class eventRing
+{
+public:
+    eventRing() {}
+    ~eventRing();
+
+    // Creates (or takes over) the shared memory object. Not fatal if it fails -
+    // publishing just becomes a no-op.
+    bool Open();
+
+    void Close();
+
+    void Publish(uint32_t type, uint32_t port, const int32_t *values, uint8_t valuesCount);
+
+private:
+    eventRingHeader_s *header = nullptr;
+    eventRecord_s *records = nullptr;
+};
+
+#endif // EVENTRING_H
@@ -0,0 +1,185 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "ffrelay.h"
+#include "gunservice.h"
+#include "constants.h"
+#include <QLocalSocket>
+#include <QSerialPort>
+#include <QtDebug>
+
+ffRelay::ffRelay(gunService *parent)
+    : QObject(parent)
+    , service(parent)
+{
+    connect(&server, &QLocalServer::newConnection, this, &ffRelay::server_newConnection);
+    connect(service, &gunService::gunIdle, this, &ffRelay::service_gunIdle);
+    connect(service, &gunService::gunClosed, this, &ffRelay::service_gunClosed);
+    latencyClock.start();
+}
+
+bool ffRelay::Start()
+{
+    // only ever started by a service that already won the right to run, so any socket here is stale.
+    QLocalServer::removeServer(FFRELAY_NAME);
+    if(!server.listen(FFRELAY_NAME)) {
+        qDebug() << "Couldn't listen on" << FFRELAY_NAME << "-" << server.errorString();
+        return false;
+    }
+    qDebug() << "Force feedback relay listening @" << server.fullServerName();
+    return true;
+}
+
+void ffRelay::server_newConnection()
+{
+    while(server.hasPendingConnections()) {
+        QLocalSocket *client = server.nextPendingConnection();
+        connect(client, &QLocalSocket::readyRead, this, &ffRelay::client_readyRead);
+        connect(client, &QLocalSocket::disconnected, client, &QLocalSocket::deleteLater);
+    }
+}
+
+void ffRelay::client_readyRead()
+{
+    QLocalSocket *client = qobject_cast<QLocalSocket*>(sender());
+    if(!client) {
+        return;
+    }
+    // stamp the whole batch as soon as we see it, so parsing counts towards latency too.
+    const qint64 received = latencyClock.nsecsElapsed();
+    while(client->canReadLine()) {
+        QByteArray line = client->readLine().trimmed();
+        if(line == "stats") {
+            qint64 latencyAvg = sentCount ? latencyTotal / qint64(sentCount) : 0;
+            client->write(QString("STATS:%1,%2,%3,%4,%5\n")
+                          .arg(sentCount)
+                          .arg(latencyMin / 1000)
+                          .arg(latencyAvg / 1000)
+                          .arg(latencyMax / 1000)
+                          .arg(droppedCount).toLocal8Bit());
+        } else if(!line.isEmpty()) {
+            Dispatch(line, received);
+        }
+    }
+}
+
+void ffRelay::Dispatch(const QByteArray &line, qint64 received)
+{
+    QList<QByteArray> args = line.split(' ');
+    // QByteArray::split keeps empty bits between doubled up spaces.
+    args.removeAll(QByteArray());
+    if(args.length() < 2) {
+        return;
+    }
+
+    // Figure out the gun, either by path or by number.
+    QString path = QString::fromLocal8Bit(args[0]);
+    bool isIndex = false;
+    int index = args[0].toInt(&isIndex);
+    if(isIndex) {
+        const QStringList paths = service->GunPaths();
+        if(index < 1 || index > paths.length()) {
+            return;
+        }
+        path = paths[index-1];
+    }
+
+    ffCommand_s ffCommand;
+    ffCommand.received = received;
+    const QByteArray action = args[1].toLower();
+    if(action == "solenoid") {
+        ffCommand.command = "Xts";
+    } else if(action == "rumble") {
+        ffCommand.command = "Xtr";
+    } else if(action == "led" && args.length() > 2) {
+        switch(args[2].toLower().at(0)) {
+        case 'r': ffCommand.command = "XtR"; break;
+        case 'g': ffCommand.command = "XtG"; break;
+        case 'b': ffCommand.command = "XtB"; break;
+        default: return;
+        }
+    } else if(action == "raw" && args.length() > 2) {
+        // only test outputs; anything else (undocking, clearing EEPROM, bootloader) goes through the service, if at all.
+        if(!args[2].startsWith("Xt")) {
+            return;
+        }
+        ffCommand.command = args.mid(2).join(' ');
+    } else {
+        return;
+    }
+
+    if(!service->GunPort(path)) {
+        return;
+    }
+    // Fast path: straight to the wire. Otherwise wait for the gun to finish answering
+    // whatever config request it's on, so we don't trample its reply.
+    if(!service->GunBusy(path) && queues.value(path).isEmpty()) {
+        Write(path, ffCommand);
+    } else {
+        QQueue<ffCommand_s> &queue = queues[path];
+        if(queue.length() >= FFRELAY_QUEUE_MAX) {
+            queue.dequeue();
+            droppedCount++;
+        }
+        queue.enqueue(ffCommand);
+    }
+}
+
+void ffRelay::Write(const QString &path, const ffCommand_s &ffCommand)
+{
+    QSerialPort *port = service->GunPort(path);
+    if(!port) {
+        droppedCount++;
+        return;
+    }
+    port->write(ffCommand.command);
+    // push it to the driver now rather than whenever the event loop comes back around.
+    port->flush();
+
+    const qint64 latency = latencyClock.nsecsElapsed() - ffCommand.received;
+    if(!sentCount || latency < latencyMin) {
+        latencyMin = latency;
+    }
+    if(latency > latencyMax) {
+        latencyMax = latency;
+    }
+    latencyTotal += latency;
+    sentCount++;
+}
+
+void ffRelay::service_gunIdle(const QString &path)
+{
+    if(!queues.contains(path)) {
+        return;
+    }
+    QQueue<ffCommand_s> queue = queues.take(path);
+    const qint64 now = latencyClock.nsecsElapsed();
+    while(!queue.isEmpty()) {
+        ffCommand_s ffCommand = queue.dequeue();
+        if(now - ffCommand.received > qint64(FFRELAY_STALE_MS) * 1000000) {
+            droppedCount++;
+        } else {
+            Write(path, ffCommand);
+        }
+    }
+}
+
+void ffRelay::service_gunClosed(const QString &path)
+{
+    // whatever was meant for the gun before it went away doesn't get to fire when it comes back.
+    droppedCount += queues.take(path).length();
+}
@@ -0,0 +1,94 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef FFRELAY_H
+#define FFRELAY_H
+
+#include <QObject>
+#include <QLocalServer>
+#include <QElapsedTimer>
+#include <QQueue>
+#include <QMap>
+
+class gunService;
+
+// Maximum amount of force feedback commands held for a gun that's busy answering
+// a config request. Past this, the oldest get dropped - late recoil is worse than none.
+#define FFRELAY_QUEUE_MAX 8
+
+// ...and ones held longer than this (ms) are dropped instead of sent, for the same reason.
+#define FFRELAY_STALE_MS 250
+
+// Force feedback relay: other local programs (emulator output scripts and the like)
+// fire solenoid/rumble/LED commands at guns held by the background service.
+//
+// One command per line, "<gun> <action>", where <gun> is a port path or a 1-based
+// index into the service's guns, and <action> is one of:
+//   solenoid            -> single solenoid pulse
+//   rumble              -> single rumble pulse
+//   led <r|g|b>         -> set the RGB LED
+//   raw <command>       -> sent to the gun as-is, as long as it's a test output command (Xt*)
+// "stats" replies with "STATS:<sent>,<min>,<avg>,<max>,<dropped>", times in microseconds
+// from the line arriving on the socket to the command being handed to the serial driver.
+// Nothing else is ever replied, so senders can fire and forget.
+class ffRelay : public QObject
+{
+    Q_OBJECT
+
+public:
+    ffRelay(gunService *parent);
+
+    bool Start();
+
+private slots:
+    void server_newConnection();
+
+    void client_readyRead();
+
+    void service_gunIdle(const QString &path);
+
+    void service_gunClosed(const QString &path);
+
+private:
+    typedef struct ffCommand_t {
+        QByteArray command;
+        // When the line came in, off latencyClock.
+        qint64 received;
+    } ffCommand_s;
+
+    gunService *service;
+
+    QLocalServer server;
+
+    QElapsedTimer latencyClock;
+
+    // Commands waiting on a busy gun, keyed by port path.
+    QMap<QString, QQueue<ffCommand_s>> queues;
+
+    // Latency bookkeeping, in nanoseconds.
+    quint64 sentCount = 0;
+    quint64 droppedCount = 0;
+    qint64 latencyMin = 0;
+    qint64 latencyMax = 0;
+    qint64 latencyTotal = 0;
+
+    void Dispatch(const QByteArray &line, qint64 received);
+
+    void Write(const QString &path, const ffCommand_s &ffCommand);
+};
+
+#endif // FFRELAY_H
@@ -0,0 +1,343 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "fleetaudit.h"
+#include "gunservice.h"
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSerialPort>
+#include <QTextStream>
+#include <QThread>
+#include <QtDebug>
+
+gunAudit_s fleetAudit::AuditPort(const QSerialPortInfo &portInfo)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    gunAudit_s audit;
+    audit.port = portInfo.systemLocation();
+    audit.serialNumber = portInfo.serialNumber();
+
+    QSerialPort port(portInfo);
+    port.setBaudRate(QSerialPort::Baud9600);
+    if(!port.open(QIODevice::ReadWrite)) {
+        audit.error = "Port is in use";
+        audit.elapsedMs = timer.elapsed();
+        return audit;
+    }
+    // windows needs DTR enabled to actually read responses.
+    port.setDataTerminalReady(true);
+
+    // Same sequence & decoding as the window's load.
+    gunReplies_s replies;
+    if(gunConfig::Query(port, replies) != queryOk) {
+        audit.error = gunConfig::Decode(replies)->error;
+    } else {
+        audit.config = gunConfig::Decode(replies);
+        audit.error = audit.config->error;
+
+        // Guns with a sensor report temperature on their own every so often while docked,
+        // so just listen for a bit.
+        QElapsedTimer tempTimer;
+        tempTimer.start();
+        while(audit.temperature < 0 && tempTimer.elapsed() < 1500) {
+            if(!port.canReadLine() && !port.waitForReadyRead(1500 - tempTimer.elapsed())) {
+                break;
+            }
+            while(port.canReadLine()) {
+                QString line = port.readLine().trimmed();
+                if(line.contains("Temperature:")) {
+                    audit.temperature = line.right(2).toInt();
+                }
+            }
+        }
+
+        audit.ok = audit.error.isEmpty();
+    }
+
+    port.write("XE");
+    port.waitForBytesWritten(2000);
+    port.waitForReadyRead(2000);
+    port.close();
+    audit.elapsedMs = timer.elapsed();
+    return audit;
+}
+
+QVector<gunAudit_s> fleetAudit::AuditAll()
+{
+    QList<QSerialPortInfo> portsList;
+    for(const QSerialPortInfo &info : QSerialPortInfo::availablePorts()) {
+        if(info.vendorIdentifier() == 0xF143) {
+            portsList.append(info);
+        }
+    }
+
+    // Borrow anything the background service is holding onto.
+    QStringList borrowed;
+    for(const QSerialPortInfo &info : std::as_const(portsList)) {
+        if(gunService::RequestPort(info.systemLocation(), true)) {
+            borrowed.append(info.systemLocation());
+        }
+    }
+
+    // Every gun gets its own thread & port, so the whole floor takes about as long as the slowest gun.
+    QVector<gunAudit_s> audits(portsList.length());
+    QList<QThread*> workers;
+    for(int i = 0; i < portsList.length(); i++) {
+        const QSerialPortInfo info = portsList[i];
+        gunAudit_s *result = &audits[i];
+        workers.append(QThread::create([info, result]() {
+            *result = AuditPort(info);
+        }));
+        workers.last()->start();
+    }
+    for(QThread *worker : std::as_const(workers)) {
+        worker->wait();
+        delete worker;
+    }
+
+    for(const QString &path : std::as_const(borrowed)) {
+        gunService::RequestPort(path, false);
+    }
+    return audits;
+}
+
+QJsonObject fleetAudit::ToJson(const gunAudit_s &audit)
+{
+    QJsonObject gun;
+    gun["port"] = audit.port;
+    gun["serialNumber"] = audit.serialNumber;
+    gun["ok"] = audit.ok;
+    gun["error"] = audit.error;
+    gun["elapsedMs"] = audit.elapsedMs;
+    if(audit.config->boardName.isEmpty()) {
+        return gun;
+    }
+
+    gunConfig::ToJson(*audit.config, gun);
+
+    if(audit.temperature >= 0) {
+        gun["temperature"] = audit.temperature;
+    } else {
+        gun["temperature"] = QJsonValue();
+    }
+    return gun;
+}
+
+gunAudit_s fleetAudit::FromJson(const QJsonObject &gun)
+{
+    gunAudit_s audit;
+    audit.port = gun["port"].toString();
+    audit.serialNumber = gun["serialNumber"].toString();
+    audit.ok = gun["ok"].toBool();
+    audit.error = gun["error"].toString();
+    audit.elapsedMs = gun["elapsedMs"].toInt();
+
+    gunConfig_s *config = new gunConfig_s;
+    audit.config = gunConfigRef(config);
+
+    gunConfig::FromJson(gun, *config);
+
+    audit.temperature = gun["temperature"].toInt(-1);
+    return audit;
+}
+
+packedConfig_s fleetAudit::Pack(const gunAudit_s &audit)
+{
+    return configDiff::Pack(audit.config->boolSettings, audit.config->inputsMap.data(), audit.config->settingsTable,
+                            audit.config->tinyUSB, audit.config->board.selectedProfile, audit.config->profiles);
+}
+
+bool fleetAudit::LoadGolden(const QString &spec, gunAudit_s &golden)
+{
+    QString path = spec.section('#', 0, 0);
+    QString name = spec.section('#', 1);
+
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "Couldn't read golden config from" << path;
+        return false;
+    }
+    const QJsonArray guns = QJsonDocument::fromJson(file.readAll()).object()["guns"].toArray();
+    for(const QJsonValue &value : guns) {
+        const QJsonObject gun = value.toObject();
+        if(name.isEmpty() ? guns.count() == 1 :
+                (gun["tinyUSB"].toObject()["name"].toString() == name ||
+                 gun["serialNumber"].toString() == name ||
+                 gun["port"].toString() == name)) {
+            golden = FromJson(gun);
+            return true;
+        }
+    }
+    qDebug() << "No golden config" << (name.isEmpty() ? "(report has more than one gun, pick one with #name)" : name) << "in" << path;
+    return false;
+}
+
+// Human-readable value of a single packed field, straight from the audit (so strings come out as strings).
+static QJsonValue FieldValue(const gunAudit_s &audit, uint16_t field)
+{
+    if(field < packedPins) {
+        return audit.config->boolSettings[field - packedBools];
+    } else if(field < packedSettings) {
+        return audit.config->inputsMap[field - packedPins];
+    } else if(field < packedTinyUSBid) {
+        return qint64(audit.config->settingsTable[field - packedSettings]);
+    } else if(field == packedTinyUSBid) {
+        return audit.config->tinyUSB.tinyUSBid;
+    } else if(field == packedTinyUSBname) {
+        return audit.config->tinyUSB.tinyUSBname;
+    } else if(field == packedSelectedProfile) {
+        return audit.config->board.selectedProfile;
+    }
+    uint16_t slot = (field - packedProfiles) / profileFieldsCount;
+    if(slot >= audit.config->profiles.length()) {
+        return QJsonValue();
+    }
+    const profilesTable_s &profile = audit.config->profiles[slot];
+    switch((field - packedProfiles) % profileFieldsCount) {
+    case profTopOffset:     return profile.topOffset;
+    case profBottomOffset:  return profile.bottomOffset;
+    case profLeftOffset:    return profile.leftOffset;
+    case profRightOffset:   return profile.rightOffset;
+    case profTLled:         return profile.TLled;
+    case profTRled:         return profile.TRled;
+    case profIrSensitivity: return profile.irSensitivity;
+    case profRunMode:       return profile.runMode;
+    case profLayoutType:    return profile.layoutType;
+    case profColor:         return qint64(profile.color);
+    case profName:          return profile.profName;
+    }
+    return QJsonValue();
+}
+
+QJsonObject fleetAudit::DriftJson(const gunAudit_s &golden, const gunAudit_s &audit, const configDiff_t &diff)
+{
+    QJsonObject fields;
+    for(uint16_t i = 0; i < packedFieldsCount; i++) {
+        if(diff.test(i)) {
+            QJsonObject field;
+            field["golden"] = FieldValue(golden, i);
+            field["actual"] = FieldValue(audit, i);
+            fields[configDiff::FieldName(i)] = field;
+        }
+    }
+    return fields;
+}
+
+QString fleetAudit::SummaryTable(const QVector<gunAudit_s> &audits, const QVector<configDiff_t> &drifts)
+{
+    QString table;
+    QTextStream out(&table);
+    out << QString("%1 %2 %3 %4 %5 %6 %7 %8\n")
+           .arg("Port", -16).arg("Board", -20).arg("Firmware", -20)
+           .arg("USB ID", -8).arg("USB Name", -16).arg("Temp", -6).arg("Drift", -6).arg("Status");
+    for(int i = 0; i < audits.length(); i++) {
+        const gunAudit_s &audit = audits[i];
+        QString drift = "-";
+        if(!drifts.isEmpty() && audit.ok) {
+            drift = QString::number(drifts[i].count());
+        }
+        out << QString("%1 %2 %3 %4 %5 %6 %7 %8\n")
+               .arg(audit.port, -16)
+               .arg(audit.config->boardName.isEmpty() ? "-" : audit.config->boardName, -20)
+               .arg(audit.config->boardName.isEmpty() ? "-" : QString("v%1 %2").arg(audit.config->board.versionNumber).arg(audit.config->board.versionCodename), -20)
+               .arg(audit.config->tinyUSB.tinyUSBid.isEmpty() ? "-" : audit.config->tinyUSB.tinyUSBid, -8)
+               .arg(audit.config->tinyUSB.tinyUSBname.isEmpty() ? "-" : audit.config->tinyUSB.tinyUSBname, -16)
+               .arg(audit.temperature >= 0 ? QString("%1C").arg(audit.temperature) : "-", -6)
+               .arg(drift, -6)
+               .arg(audit.ok ? "OK" : audit.error);
+    }
+    return table;
+}
+
+int fleetAudit::Run(const QString &outPath, const QString &goldenSpec)
+{
+    gunAudit_s golden;
+    if(!goldenSpec.isEmpty() && !LoadGolden(goldenSpec, golden)) {
+        return 1;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QVector<gunAudit_s> audits = AuditAll();
+
+    // Pack everything up front, then it's one tight compare per gun.
+    QVector<configDiff_t> drifts;
+    if(!goldenSpec.isEmpty()) {
+        QVector<packedConfig_s> packedAudits(audits.length());
+        for(int i = 0; i < audits.length(); i++) {
+            packedAudits[i] = Pack(audits[i]);
+        }
+        drifts = configDiff::CompareMany(Pack(golden), packedAudits);
+        // each gun's own calibration & identity are supposed to differ, and
+        // pin maps aren't in play if neither side uses custom pins.
+        const configDiff_t unitMask = configDiff::UnitMask();
+        for(int i = 0; i < audits.length(); i++) {
+            drifts[i] &= ~unitMask;
+            if(!golden.config->boolSettings[customPins] && !audits[i].config->boolSettings[customPins]) {
+                drifts[i] &= ~configDiff::PinsMask();
+            }
+        }
+    }
+
+    QJsonArray guns;
+    int failures = 0;
+    int drifted = 0;
+    for(int i = 0; i < audits.length(); i++) {
+        QJsonObject gun = ToJson(audits[i]);
+        if(!audits[i].ok) {
+            failures++;
+        } else if(!drifts.isEmpty()) {
+            gun["drift"] = DriftJson(golden, audits[i], drifts[i]);
+            if(drifts[i].any()) {
+                drifted++;
+            }
+        }
+        guns.append(gun);
+    }
+    QJsonObject report;
+    report["generated"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    report["elapsedMs"] = timer.elapsed();
+    report["gunsCount"] = audits.length();
+    report["failures"] = failures;
+    if(!goldenSpec.isEmpty()) {
+        report["golden"] = goldenSpec;
+        report["drifted"] = drifted;
+    }
+    report["guns"] = guns;
+
+    QFile file(outPath);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qDebug() << "Couldn't write audit report to" << outPath;
+        return 1;
+    }
+    file.write(QJsonDocument(report).toJson());
+    file.close();
+
+    QTextStream out(stdout);
+    out << SummaryTable(audits, drifts);
+    out << QString("\n%1 gun(s) audited in %2 ms, %3 failure(s)").arg(audits.length()).arg(timer.elapsed()).arg(failures);
+    if(!goldenSpec.isEmpty()) {
+        out << QString(", %1 drifted from %2").arg(drifted).arg(goldenSpec);
+    }
+    out << QString(". Report written to %1\n").arg(outPath);
+    return (failures || drifted || audits.isEmpty()) ? 1 : 0;
+}
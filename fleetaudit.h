@@ -0,0 +1,74 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef FLEETAUDIT_H
+#define FLEETAUDIT_H
+
+#include "constants.h"
+#include "configdiff.h"
+#include "gunconfig.h"
+#include <QJsonObject>
+#include <QSerialPortInfo>
+#include <QVector>
+
+// Everything one gun told us during an audit.
+typedef struct gunAudit_t {
+    QString port;
+    QString serialNumber;
+    bool ok = false;
+    QString error;
+    qint64 elapsedMs = 0;
+
+    // decoded the same way the window loads a gun, never null.
+    gunConfigRef config = gunConfigRef(new gunConfig_s);
+    // -1 if the gun didn't report one (no sensor, or too slow)
+    int temperature = -1;
+} gunAudit_s;
+
+// One-shot inventory & health check of every attached gun, all at once.
+namespace fleetAudit {
+
+// Audits a single port; blocking, meant to be run on its own thread.
+gunAudit_s AuditPort(const QSerialPortInfo &portInfo);
+
+// Audits every attached OpenFIRE gun in parallel.
+QVector<gunAudit_s> AuditAll();
+
+QJsonObject ToJson(const gunAudit_s &audit);
+
+// Reads back a gun entry from a report.
+gunAudit_s FromJson(const QJsonObject &gun);
+
+packedConfig_s Pack(const gunAudit_s &audit);
+
+// Golden config spec is "<report.json>[#<name>]": picks the gun in a previous report whose
+// TinyUSB name, USB serial number or port matches name, or the only gun if there's no name.
+bool LoadGolden(const QString &spec, gunAudit_s &golden);
+
+// Only the fields that differ from golden, as "field": {"golden": x, "actual": y}.
+QJsonObject DriftJson(const gunAudit_s &golden, const gunAudit_s &audit, const configDiff_t &diff);
+
+// drifts may be empty if there's no golden config to compare against.
+QString SummaryTable(const QVector<gunAudit_s> &audits, const QVector<configDiff_t> &drifts);
+
+// --audit <file> [--golden <spec>]: writes the JSON report to outPath and the summary table to stdout.
+// Returns a process exit code: 0 if every gun answered (and matched golden, if given), 1 otherwise.
+int Run(const QString &outPath, const QString &goldenSpec);
+
+}
+
+#endif // FLEETAUDIT_H
@@ -19,20 +19,44 @@
 #include "constants.h"
 #include "ui_guiwindow.h"
 #include "ui_about.h"
+#include "gunservice.h"
+#include "pinout.h"
+#include "boardpicture.h"
+#include "startupprofile.h"
+#include "pinfunctions.h"
+#include "profilesmodel.h"
+#include "toaststack.h"
+#include "pinsolver.h"
+#include "configstore.h"
 #include <QGraphicsScene>
 #include <QMessageBox>
-#include <QRadioButton>
-#include <QSvgRenderer>
-#include <QSvgWidget>
 #include <QSerialPortInfo>
 #include <QtDebug>
 #include <QProgressBar>
-#include <QProcess>
 #include <QStorageInfo>
 #include <QThread>
 #include <QColorDialog>
+#include <QHash>
+#include <QStringListModel>
+#include <QSpinBox>
+#include <QLineEdit>
+#include <QHeaderView>
+#include <QGuiApplication>
+#include <QScreen>
 #include <QInputDialog>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QDateTime>
 #include <QTimer>
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <vector>
+
+#if !defined(Q_OS_MAC) && !defined(Q_OS_WIN)
+#include <grp.h>
+#include <unistd.h>
+#endif
 
 // Currently loaded board object
 boardInfo_s board;
@@ -42,32 +66,38 @@ tinyUSBtable_s tinyUSBtable;
 // TinyUSB ident, as loaded from the board
 tinyUSBtable_s tinyUSBtable_orig;
 
-#define PROFILES_COUNT 4
 // Current calibration profiles
+// (sized to however many the gun says it has)
 QVector<profilesTable_s> profilesTable(PROFILES_COUNT);
 // Calibration profiles, as loaded from the board
 QVector<profilesTable_s> profilesTable_orig(PROFILES_COUNT);
 
+// Which packed config fields (see configdiff.h) currently differ from what's on the board.
+// Kept up to date by the field setters, so edits don't need a full DiffUpdate.
+configDiff_t dirtyFields;
+
 // Indexed array map of the current physical layout of the board.
-// Key = pin number, Value = pin function
+// Index = pin number, Value = pin function
 // Values: -2 = N/A, -1 = reserved, 0 = available, unused
-QMap<uint8_t, int8_t> currentPins;
+std::array<int8_t, 30> currentPins;
+// Set bit = that pin has a function mapped to it.
+std::bitset<30> pinsMapped;
 
-// Map of what inputs are put where,
-// Key = button/output, Value = pin number occupying, if any.
+// Reverse index of the above: what inputs are put where,
+// Index = button/output, Value = pin number occupying, if any.
 // Value of -1 means unmapped.
-// Key order based on boardInputs_e, minus 1
-// Map functions used in deduplication
-QMap<uint8_t, int8_t> inputsMap;
+// Index order based on boardInputs_e, minus 1
+// Used in deduplication, so finding whoever holds a function is a single lookup.
+std::array<int8_t, boardInputsCount-1> inputsMap;
 // Inputs map, as loaded from the board
-QMap<uint8_t, int8_t> inputsMap_orig;
+std::array<int8_t, boardInputsCount-1> inputsMap_orig;
 
 // ^^^-----Typedefs up there:----^^^
 //
 // vvv---UI Objects down here:---vvv
 
-// Guess I'll have to do the dynamic layout spawning/destroying stuff to make things work.
-// How else do I hide things lol?
+// The pins view is a pool of widgets that live as long as the app does,
+// just taken out of & put back into these layouts when a different board shows up.
 QVBoxLayout *PinsCenter;
 QGridLayout *PinsCenterSub;
 QGridLayout *PinsLeft;
@@ -79,23 +109,21 @@ QWidget *padding[30];
 
 // buttons in the test screen
 QLabel *testLabel[16];
+// indexed by testStyles_e
+QPalette testPalettes[testStylesCount];
 
-QRadioButton *selectedProfile[PROFILES_COUNT];
-QLabel *topOffset[PROFILES_COUNT];
-QLabel *bottomOffset[PROFILES_COUNT];
-QLabel *leftOffset[PROFILES_COUNT];
-QLabel *rightOffset[PROFILES_COUNT];
-QLabel *TLled[PROFILES_COUNT];
-QLabel *TRled[PROFILES_COUNT];
-QComboBox *irSens[PROFILES_COUNT];
-QComboBox *runMode[PROFILES_COUNT];
-QComboBox *layoutMode[PROFILES_COUNT];
-QPushButton *color[PROFILES_COUNT];
-QPushButton *renameBtn[PROFILES_COUNT];
-
-QSvgWidget *centerPic;
-QGraphicsScene *testScene;
-#define ALIVE_TIMER 5000
+// what the profiles tab's table shows, once it's been built.
+profilesModel *profilesTableModel = nullptr;
+
+boardPicture *centerPic;
+QGraphicsScene *testScene = nullptr;
+
+// Board whose picture & pinout are currently in the pins view, if any.
+const boardDesc_s *placedBoard = nullptr;
+// Every pin box shows the same list of functions, so they all share this one model,
+// through a filter for each distinct set of capabilities (see PinFunctions()).
+QStringListModel *pinFunctions;
+QHash<uint64_t, pinFunctionsProxy*> pinFunctionsProxies;
 
 //
 // ^^^-------GLOBAL VARS UP THERE----------^^^
@@ -103,28 +131,81 @@ QGraphicsScene *testScene;
 // vvv-------GUI METHODS DOWN HERE---------vvv
 //
 
+#if !defined(Q_OS_MAC) && !defined(Q_OS_WIN)
+// Same as looking for the group in `groups`' output, minus spawning it.
+static bool UserInGroup(const char *name)
+{
+    struct group *grp = getgrnam(name);
+    if(!grp) {
+        return false;
+    }
+    if(getegid() == grp->gr_gid) {
+        return true;
+    }
+    int count = getgroups(0, nullptr);
+    if(count <= 0) {
+        return false;
+    }
+    std::vector<gid_t> groups(count);
+    count = getgroups(count, groups.data());
+    for(int i = 0; i < count; i++) {
+        if(groups[i] == grp->gr_gid) {
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
+// Enumerating can take a good while on some systems (and Pis especially),
+// so it's done off the GUI thread and the selector gets filled in once it's back.
 void guiWindow::PortsSearch()
 {
-    serialFoundList = QSerialPortInfo::availablePorts();
+    portsThread = QThread::create([this]() {
+        portsFound = QSerialPortInfo::availablePorts();
+    });
+    connect(portsThread, &QThread::finished, this, &guiWindow::portsThread_finished);
+    connect(portsThread, &QThread::finished, portsThread, &QObject::deleteLater);
+    portsThread->start();
+}
+
+
+void guiWindow::portsThread_finished()
+{
+    serialFoundList = portsFound;
+    portsFound.clear();
+    portsThread = nullptr;
+    startupProfile::Mark("ports enumerated");
+
     if(serialFoundList.isEmpty()) {
         //statusBar()->showMessage("FATAL: No COM devices detected!");
         PopupWindow("No devices detected!", "Is the microcontroller board currently running OpenFIRE and is currently plugged in? Make sure it's connected and recognized by the PC.\n\nThis app will now close.", "ERROR", 4);
         exit(1);
     } else {
+        QStringList found;
         // Yeah, sue me, we reading this backwards to make stack management easier.
         for(int i = serialFoundList.length() - 1; i >= 0; --i) {
             if(serialFoundList[i].vendorIdentifier() == 0xF143) {
-                usbName.prepend(serialFoundList[i].systemLocation());
+                found.prepend(serialFoundList[i].systemLocation());
                 qDebug() << "Found device @" << serialFoundList[i].systemLocation();
             } else {
                 qDebug() << "Deleting dummy device" << serialFoundList[i].systemLocation();
                 serialFoundList.removeAt(i);
             }
         }
-        if(!usbName.length()) {
+        if(found.isEmpty()) {
             PopupWindow("No OpenFIRE devices detected!", "Is the microcontroller board currently running OpenFIRE and is currently plugged in? Make sure it's connected and recognized by the PC.\n\nThis app will now close.", "ERROR", 4);
             exit(1);
         }
+        // "[No device]" is already sitting at index 0.
+        usbName.append(found);
+        ui->comPortSelector->addItems(found);
+    }
+
+    if(!pendingArgs.isEmpty()) {
+        QStringList args = pendingArgs;
+        pendingArgs.clear();
+        HandleArguments(args);
     }
 }
 
@@ -133,14 +214,11 @@ guiWindow::guiWindow(QWidget *parent)
     , ui(new Ui::guiWindow)
 {
     ui->setupUi(this);
+    startupProfile::Mark("ui setup");
 
 #if !defined(Q_OS_MAC) && !defined(Q_OS_WIN)
-    if(qEnvironmentVariable("USER") != "root") {
-        QProcess *externalProg = new QProcess;
-        QStringList args;
-        externalProg->start("/usr/bin/groups", args);
-        externalProg->waitForFinished();
-        if(!externalProg->readAllStandardOutput().contains("dialout")) {
+    if(geteuid() != 0) {
+        if(!UserInGroup("dialout")) {
             PopupWindow("User doesn't have serial permissions!", QString("Currently, your user is not allowed to have access to serial devices.\n\nTo add yourself to the right group, run this command in a terminal and then re-login to your session: \n\nsudo usermod -aG dialout %1").arg(qEnvironmentVariable("USER")), "Permission error", 2);
             exit(0);
         }
@@ -149,17 +227,19 @@ guiWindow::guiWindow(QWidget *parent)
         exit(2);
     }
 #endif
+    startupProfile::Mark("permissions check");
 
     connect(&serialPort, &QSerialPort::readyRead, this, &guiWindow::serialPort_readyRead);
 
-    // just to be sure, init the inputsMap hashes
-    for(uint8_t i = 0; i < boardInputsCount-1; i++) {
-        inputsMap[i] = -1;
-        inputsMap_orig[i] = -1;
-    }
+    // not fatal if this doesn't work, outside tools just won't see anything.
+    eventsRing.Open();
+
+    // just to be sure, init the pin maps
+    currentPins.fill(btnUnmapped);
+    inputsMap.fill(-1);
+    inputsMap_orig.fill(-1);
 
-    // sending all these children to die upon comPortSelector->on_currentIndexChanged
-    // (which gets fired immediately after ui->comPortSelector->addItems).
+    // Pins view widgets are made once here, and only moved around by PinsLayout from then on.
     PinsCenter = new QVBoxLayout();
     PinsCenterSub = new QGridLayout();
     PinsLeft = new QGridLayout();
@@ -169,130 +249,30 @@ guiWindow::guiWindow(QWidget *parent)
     ui->PinsTopHalf->addLayout(PinsCenter);
     ui->PinsTopHalf->addLayout(PinsRight);
 
+    centerPic = new boardPicture();
+    centerPic->setSizePolicy(QSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding));
+    centerPic->hide();
+    PinsCenter->addWidget(centerPic);
+    PinsCenter->addLayout(PinsCenterSub);
+
+    pinFunctions = new QStringListModel(valuesNameList, this);
     for(uint8_t i = 0; i < 30; i++) {
-        pinBoxes[i] = new QComboBox();
+        pinBoxes[i] = new QComboBox(ui->pinsTab);
+        pinBoxes[i]->setSizePolicy(QSizePolicy::Fixed,QSizePolicy::Fixed);
+        pinBoxes[i]->hide();
         connect(pinBoxes[i], SIGNAL(activated(int)), this, SLOT(pinBoxes_activated(int)));
-        pinLabel[i] = new QLabel();
+        pinLabel[i] = new QLabel(QString("<GPIO%1>").arg(i), ui->pinsTab);
+        pinLabel[i]->setEnabled(false);
         pinLabel[i]->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
-        padding[i] = new QWidget();
+        pinLabel[i]->hide();
+        padding[i] = new QWidget(ui->pinsTab);
         padding[i]->setMinimumHeight(25);
+        padding[i]->hide();
     }
+    startupProfile::Mark("pins widget pool");
 
-    // These can actually stay, tho.
-    for(uint8_t i = 0; i < PROFILES_COUNT; i++) {
-        renameBtn[i] = new QPushButton();
-        renameBtn[i]->setFlat(true);
-        renameBtn[i]->setFixedWidth(20);
-        renameBtn[i]->setIcon(QIcon(":/icon/edit.png"));
-        connect(renameBtn[i], SIGNAL(clicked()), this, SLOT(renameBoxes_clicked()));
-        selectedProfile[i] = new QRadioButton(QString("%1.").arg(i+1));
-        connect(selectedProfile[i], SIGNAL(toggled(bool)), this, SLOT(selectedProfile_isChecked(bool)));
-        topOffset[i] = new QLabel("0");
-        bottomOffset[i] = new QLabel("0");
-        leftOffset[i] = new QLabel("0");
-        rightOffset[i] = new QLabel("0");
-        TLled[i] = new QLabel("0");
-        TRled[i] = new QLabel("0");
-        irSens[i] = new QComboBox();
-        runMode[i] = new QComboBox();
-        layoutMode[i] = new QComboBox();
-        color[i] = new QPushButton();
-        topOffset[i]->setAlignment(Qt::AlignCenter);
-        bottomOffset[i]->setAlignment(Qt::AlignCenter);
-        leftOffset[i]->setAlignment(Qt::AlignCenter);
-        rightOffset[i]->setAlignment(Qt::AlignCenter);
-        TLled[i]->setAlignment(Qt::AlignCenter);
-        TRled[i]->setAlignment(Qt::AlignCenter);
-        irSens[i]->addItem("Default");
-        irSens[i]->addItem("Higher");
-        irSens[i]->addItem("Highest");
-        connect(irSens[i], SIGNAL(activated(int)), this, SLOT(irBoxes_activated(int)));
-        runMode[i]->addItem("Normal");
-        runMode[i]->addItem("1-Frame Avg");
-        runMode[i]->addItem("2-Frame Avg");
-        layoutMode[i]->addItems({"Square", "Diamond"});
-        connect(layoutMode[i], SIGNAL(activated(int)), this, SLOT(layoutBoxes_activated(int)));
-        connect(runMode[i], SIGNAL(activated(int)), this, SLOT(runModeBoxes_activated(int)));
-        color[i]->setFixedWidth(32);
-        connect(color[i], SIGNAL(clicked()), this, SLOT(colorBoxes_clicked()));
-        ui->profilesArea->addWidget(renameBtn[i], i+1, 0, 1, 1);
-        ui->profilesArea->addWidget(selectedProfile[i], i+1, 1, 1, 1);
-        ui->profilesArea->addWidget(topOffset[i], i+1, 2, 1, 1);
-        ui->profilesArea->addWidget(bottomOffset[i], i+1, 4, 1, 1);
-        ui->profilesArea->addWidget(leftOffset[i], i+1, 6, 1, 1);
-        ui->profilesArea->addWidget(rightOffset[i], i+1, 8, 1, 1);
-        ui->profilesArea->addWidget(TLled[i], i+1, 10, 1, 1);
-        ui->profilesArea->addWidget(TRled[i], i+1, 12, 1, 1);
-        ui->profilesArea->addWidget(irSens[i], i+1, 14, 1, 1);
-        ui->profilesArea->addWidget(runMode[i], i+1, 16, 1, 1);
-        ui->profilesArea->addWidget(layoutMode[i], i+1, 18, 1, 1);
-        ui->profilesArea->addWidget(color[i], i+1, 20, 1, 1);
-    }
-
-    // Setup test screen buttons
-    for(uint8_t i = 0; i < 16; i++) {
-        testLabel[i] = new QLabel;
-        if(i == 14) {
-            testLabel[i]->setText(valuesNameList[tempPin]);
-        } else if(i == 15) {
-            testLabel[i]->setText("Analog Stick");
-        } else {
-            testLabel[i]->setText(valuesNameList[i+1]);
-        }
-        testLabel[i]->setEnabled(false);
-        testLabel[i]->setAlignment(Qt::AlignCenter);
-        testLabel[i]->setFrameStyle(QFrame::Box | QFrame::Raised);
-        if(i == 15) {
-            ui->buttonsTestLayout->addWidget(testLabel[i], 3, 3, 1, 1);
-        } else if(i == 14) {
-            ui->buttonsTestLayout->addWidget(testLabel[i], 3, 1, 1, 1);
-        } else if(i > 9) {
-            ui->buttonsTestLayout->addWidget(testLabel[i], 2, i-10, 1, 1);
-        } else if(i > 4) {
-            ui->buttonsTestLayout->addWidget(testLabel[i], 1, i-5, 1, 1);
-        } else {
-            ui->buttonsTestLayout->addWidget(testLabel[i], 0, i, 1, 1);
-        }
-    }
-    ui->buttonsTestLayout->setRowMinimumHeight(0, 32);
-    ui->buttonsTestLayout->setRowMinimumHeight(1, 32);
-    ui->buttonsTestLayout->setRowMinimumHeight(2, 32);
-    ui->buttonsTestLayout->setRowMinimumHeight(3, 32);
-
-    // Setup Test Mode screen colors
-    testPointTLPen.setColor(Qt::green);
-    testPointTRPen.setColor(Qt::green);
-    testPointBLPen.setColor(Qt::blue);
-    testPointBRPen.setColor(Qt::blue);
-    testPointMedPen.setColor(Qt::gray);
-    testPointDPen.setColor(Qt::red);
-    testPointTLPen.setWidth(3);
-    testPointTRPen.setWidth(3);
-    testPointBLPen.setWidth(3);
-    testPointBRPen.setWidth(3);
-    testPointMedPen.setWidth(3);
-    testPointDPen.setWidth(3);
-    testPointTL.setPen(testPointTLPen);
-    testPointTR.setPen(testPointTRPen);
-    testPointBL.setPen(testPointBLPen);
-    testPointBR.setPen(testPointBRPen);
-    testPointMed.setPen(testPointMedPen);
-    testPointD.setPen(testPointDPen);
-
-    // Actually setup the Test Mode scene
-    testScene = new QGraphicsScene();
-    testScene->setSceneRect(0, 0, 1024, 768);
-    testScene->setBackgroundBrush(Qt::darkGray);
-    ui->testView->setScene(testScene);
-    testScene->addItem(&testBox);
-    testScene->addItem(&testPointTL);
-    testScene->addItem(&testPointTR);
-    testScene->addItem(&testPointBL);
-    testScene->addItem(&testPointBR);
-    testScene->addItem(&testPointMed);
-    testScene->addItem(&testPointD);
-    // TODO: is there a way of dynamically scaling QGraphicsViews?
-    ui->testView->scale(0.5, 0.5);
+    // settings tab widgets, as listed in settingsSchema
+    SettingsBind();
 
     // hiding tUSB elements by default since this can't be done from default
     ui->tUSBLayoutAdvanced->setVisible(false);
@@ -302,30 +282,104 @@ guiWindow::guiWindow(QWidget *parent)
 
     // Finally get to the thing!
     aliveTimer = new QTimer();
+    toasts = new toastStack(ui->centralwidget);
+
+    // test screen redraws go at the display's pace, however fast the gun's talking.
+    qreal refreshRate = QGuiApplication::primaryScreen() ? QGuiApplication::primaryScreen()->refreshRate() : 0;
+    testFrameTimer.setSingleShot(true);
+    testFrameTimer.setInterval(qMax(1, qRound(1000 / (refreshRate > 0 ? refreshRate : 60))));
+    connect(&testFrameTimer, &QTimer::timeout, this, &guiWindow::testFrameTimer_timeout);
     connect(aliveTimer, &QTimer::timeout, this, &guiWindow::aliveTimer_timeout);
     statusBar()->showMessage("Welcome to the OpenFIRE app!", 3000);
     PortsSearch();
-    usbName.prepend("[No device]");
+    usbName.append("[No device]");
     ui->productIdConverted->setEnabled(false);
     ui->productIdInput->setValidator(new QIntValidator());
     // TODO: what's a good validator to only accept character values within the range of an unsigned char?
     //ui->productNameInput->setValidator(new QRegExpValidator(QRegExp("[A-Za-z0-9_]+"), this));
     ui->comPortSelector->addItems(usbName);
+    ui->actionUndo->setShortcut(QKeySequence::Undo);
+    ui->actionRedo->setShortcut(QKeySequence::Redo);
+
+    // profiles & test screen get built whenever they're first shown, unless one of them starts out on top.
+    on_tabWidget_currentChanged(ui->tabWidget->currentIndex());
+    startupProfile::Mark("window constructed");
+}
+
+// Command line arguments - either our own, or ones handed off from a second launch.
+void guiWindow::HandleArguments(const QStringList &args)
+{
+    // someone tried opening us again, so come to the front.
+    setWindowState((windowState() & ~Qt::WindowMinimized) | Qt::WindowActive);
+    raise();
+    activateWindow();
+
+    // --port can't be matched to anything until the ports are in, so pick this back up then.
+    if(portsThread) {
+        pendingArgs.append(args);
+        return;
+    }
+
+    for(int i = 0; i < args.length(); i++) {
+        if(args[i] == "--port" && i+1 < args.length()) {
+            i++;
+            int portIndex = usbName.indexOf(args[i]);
+            if(portIndex > 0) {
+                ui->comPortSelector->setCurrentIndex(portIndex);
+            } else {
+                statusBar()->showMessage(QString("Requested port %1 isn't a detected OpenFIRE device.").arg(args[i]), 5000);
+            }
+        } else if(args[i] == "--apply" && i+1 < args.length()) {
+            i++;
+            pendingApply = args[i];
+        }
+    }
+
+    // a config file needs a gun to go on, so it waits for one to finish loading if there isn't one yet.
+    if(!pendingApply.isEmpty()) {
+        if(serialPort.isOpen() && loadedConfig && !loadThread) {
+            ConfigFileApply(pendingApply);
+            pendingApply.clear();
+        } else {
+            statusBar()->showMessage(QString("%1 will be applied once a gun is selected.").arg(pendingApply), 5000);
+        }
+    }
 }
 
 guiWindow::~guiWindow()
 {
+    if(portsThread) {
+        portsThread->wait();
+    }
+    if(loadThread) {
+        loadThread->wait();
+    }
     if(serialPort.isOpen()) {
         statusBar()->showMessage("Sending undock request to board...");
         serialPort.write("XE");
         serialPort.waitForBytesWritten(2000);
         serialPort.waitForReadyRead(2000);
         serialPort.close();
+        ServiceHandBack();
     }
     delete ui;
 }
 
 
+// Only here to time the first frame for --startup-profile.
+void guiWindow::paintEvent(QPaintEvent *event)
+{
+    static bool painted = false;
+    if(!painted) {
+        painted = true;
+        startupProfile::Mark("first frame");
+    }
+    QMainWindow::paintEvent(event);
+}
+
+
+// Blocks in its own event loop until dismissed, so only for when nothing else is going on anyway
+// (i.e. startup failures on the way out). Anything during serial work goes through Notify() or Confirm().
 void guiWindow::PopupWindow(QString errorTitle, QString errorMessage, QString windowTitle, int errorType)
 {
     QMessageBox messageBox;
@@ -355,216 +409,175 @@ void guiWindow::PopupWindow(QString errorTitle, QString errorMessage, QString wi
     serialPort.clearError();
 }
 
-// TODO: Copy loaded values to use for comparison to determine state of save button.
-void guiWindow::SerialLoad()
-{
-    serialActive = true;
-    serialPort.write("Xlb");
-    if(serialPort.waitForBytesWritten(2000)) {
-        if(serialPort.waitForReadyRead(2000)) {
-            // booleans
-            QString bufStr = serialPort.readLine().trimmed();
-            QStringList buffer = bufStr.split(',');
-            for(uint8_t i = 0; i < boolTypesCount; i++) {
-                boolSettings[i] = buffer[i].toInt();
-                boolSettings_orig[i] = boolSettings[i];
-            }
 
-            // pins
-            if(boolSettings[customPins]) {
-                serialPort.write("Xlp");
-                serialPort.waitForBytesWritten(2000);
-                serialPort.waitForReadyRead(2000);
-                bufStr = serialPort.readLine().trimmed();
-                buffer = bufStr.split(',');
-                for(uint8_t i = 0; i < boardInputsCount-1; i++) {
-                    inputsMap_orig[i] = buffer[i].toInt();
-                }
-                inputsMap = inputsMap_orig;
-            }
+// Shows a toast and returns straight away; severity is a notifySeverity_e.
+void guiWindow::Notify(const QString &title, const QString &message, uint8_t severity)
+{
+    toasts->Show(title, message, severity);
+    if(severity >= notifyWarning) {
+        serialPort.clearError();
+    }
+}
 
-            // settings
-            serialPort.write("Xls");
-            serialPort.waitForBytesWritten(2000);
-            serialPort.waitForReadyRead(2000);
-            bufStr = serialPort.readLine().trimmed();
-            buffer = bufStr.split(',');
-            for(uint8_t i = 0; i < settingsTypesCount; i++) {
-                settingsTable[i] = buffer[i].toInt();
-                settingsTable_orig[i] = settingsTable[i];
-            }
 
-            // profiles
-            for(uint8_t i = 0; i < PROFILES_COUNT; i++) {
-                QString genString = QString("XlP%1").arg(i);
-                serialPort.write(genString.toLocal8Bit());
-                serialPort.waitForBytesWritten(2000);
-                serialPort.waitForReadyRead(2000);
-                bufStr = serialPort.readLine().trimmed();
-                buffer = bufStr.split(',');
-                topOffset[i]->setText(buffer[0]), profilesTable[i].topOffset = buffer[0].toInt(), profilesTable_orig[i].topOffset = profilesTable[i].topOffset;
-                bottomOffset[i]->setText(buffer[1]), profilesTable[i].bottomOffset = buffer[1].toInt(), profilesTable_orig[i].bottomOffset = profilesTable[i].bottomOffset;
-                leftOffset[i]->setText(buffer[2]), profilesTable[i].leftOffset = buffer[2].toInt(), profilesTable_orig[i].leftOffset = profilesTable[i].leftOffset;
-                rightOffset[i]->setText(buffer[3]), profilesTable[i].rightOffset = buffer[3].toInt(), profilesTable_orig[i].rightOffset = profilesTable[i].rightOffset;
-                TLled[i]->setText(buffer[4]), profilesTable[i].TLled = buffer[4].toFloat(), profilesTable_orig[i].TLled = profilesTable[i].TLled;
-                TRled[i]->setText(buffer[5]), profilesTable[i].TRled = buffer[5].toFloat(), profilesTable_orig[i].TRled = profilesTable[i].TRled;
-                profilesTable[i].irSensitivity = buffer[6].toInt(), profilesTable_orig[i].irSensitivity = profilesTable[i].irSensitivity, irSens[i]->setCurrentIndex(profilesTable[i].irSensitivity), irSensOldIndex[i] = profilesTable[i].irSensitivity;
-                profilesTable[i].runMode = buffer[7].toInt(), profilesTable_orig[i].runMode = profilesTable[i].runMode, runMode[i]->setCurrentIndex(profilesTable[i].runMode), runModeOldIndex[i] = profilesTable[i].runMode;
-                layoutMode[i]->setCurrentIndex(buffer[8].toInt()), profilesTable[i].layoutType = buffer[8].toInt(), profilesTable_orig[i].layoutType = profilesTable[i].layoutType;
-                color[i]->setStyleSheet(QString("background-color: #%1").arg(buffer[9].toLong(), 6, 16, QLatin1Char('0'))), profilesTable[i].color = buffer[9].toLong(), profilesTable_orig[i].color = profilesTable[i].color;
-                selectedProfile[i]->setText(buffer[10]), profilesTable[i].profName = buffer[10], profilesTable_orig[i].profName = profilesTable[i].profName;
-            }
-            serialActive = false;
-        } else {
-            PopupWindow("Data hasn't arrived!", "Device was detected, but settings request wasn't received in time!\nThis can happen if the app was closed in the middle of an operation.\n\nTry selecting the device again.", "Sync Error!", 4);
-            //qDebug() << "Didn't receive any data in time! Dammit Seong, you jiggled the cable too much again!";
+// Asks a yes/no question without a nested event loop: the window's input is blocked while it's up,
+// but the port keeps being read, and whichever of accepted/declined applies runs once it's answered.
+void guiWindow::Confirm(const QString &title, const QString &message, const QString &windowTitle, int errorType,
+                        std::function<void()> accepted, std::function<void()> declined)
+{
+    QMessageBox *messageBox = new QMessageBox(this);
+    messageBox->setAttribute(Qt::WA_DeleteOnClose);
+    messageBox->setText(title);
+    messageBox->setInformativeText(message);
+    messageBox->setWindowTitle(windowTitle);
+    switch(errorType) {
+    case notifyQuestion:
+        messageBox->setIcon(QMessageBox::Question);
+        break;
+    case notifyInfo:
+        messageBox->setIcon(QMessageBox::Information);
+        break;
+    case notifyWarning:
+        messageBox->setIcon(QMessageBox::Warning);
+        break;
+    case notifyError:
+        messageBox->setIcon(QMessageBox::Critical);
+        break;
+    }
+    messageBox->setStandardButtons(QMessageBox::Yes | QMessageBox::No);
+    messageBox->setDefaultButton(QMessageBox::Yes);
+    connect(messageBox, &QMessageBox::finished, this, [accepted, declined](int result) {
+        if(result == QMessageBox::Yes) {
+            if(accepted) { accepted(); }
+        } else if(declined) {
+            declined();
         }
-    } else {
-        qDebug() << "Couldn't send any data in time! Does the port even exist??? Fucking dammit Seong!?!?!?";
+    });
+    messageBox->open();
+}
+
+// The replies are decoded into a snapshot off the GUI thread, and ConfigApply() puts it up once it's back.
+void guiWindow::SerialLoad(const gunReplies_s &replies)
+{
+    // nothing of the old board should be touchable until the new one's in.
+    ui->tabWidget->setEnabled(false);
+    loadThread = QThread::create([this, replies]() {
+        decodedConfig = gunConfig::Decode(replies);
+    });
+    connect(loadThread, &QThread::finished, this, &guiWindow::loadThread_finished);
+    connect(loadThread, &QThread::finished, loadThread, &QObject::deleteLater);
+    loadThread->start();
+}
+
+
+void guiWindow::loadThread_finished()
+{
+    // a load for a port that's since been switched away from.
+    if(sender() != loadThread.data()) {
+        return;
+    }
+    loadThread = nullptr;
+    loadedConfig = decodedConfig;
+    decodedConfig.reset();
+    serialActive = false;
+
+    if(!loadedConfig->error.isEmpty()) {
+        Notify("Data hasn't arrived!", QString("Device was detected, but settings request wasn't received in time! (%1)\nThis can happen if the app was closed in the middle of an operation.\n\nTry selecting the device again.").arg(loadedConfig->error), notifyError);
+        ui->comPortSelector->setCurrentIndex(0);
+        return;
     }
+    ConfigApply();
 }
 
 // Bool returns success (false if failed)
-// TODO: copy TinyUSB values to a backup for comparison to determine availability of save btn functionality
 bool guiWindow::SerialInit(int portNum)
 {
+    // If the background service is holding this gun, ask it to let go first.
+    if(gunService::RequestPort(serialFoundList[portNum].systemLocation(), true)) {
+        servicePort = serialFoundList[portNum].systemLocation();
+    }
     serialPort.setPort(serialFoundList[portNum]);
+    gunSerial = serialFoundList[portNum].serialNumber();
+    if(gunSerial.isEmpty()) {
+        gunSerial = serialFoundList[portNum].systemLocation();
+    }
     serialPort.setBaudRate(QSerialPort::Baud9600);
     if(serialPort.open(QIODevice::ReadWrite)) {
         qDebug() << "Opened port successfully!";
         serialActive = true;
         // windows needs DTR enabled to actually read responses.
         serialPort.setDataTerminalReady(true);
-        serialPort.write("XP");
-        if(serialPort.waitForBytesWritten(2000)) {
-            if(serialPort.waitForReadyRead(2000)) {
-                QString bufStr = serialPort.readLine().trimmed();
-                QStringList buffer = bufStr.split(',');
-                if(buffer[0].contains("OpenFIRE")) {
-                    qDebug() << "OpenFIRE gun detected!";
-                    board.versionNumber = buffer[1].toFloat();
-                    qDebug() << "Version number:" << board.versionNumber;
-                    board.versionCodename = buffer[2];
-                    qDebug() << "Version codename:" << board.versionCodename;
-                    if(buffer[3] == "rpipico") {
-                        board.type = rpipico;
-                    } else if(buffer[3] == "rpipicow") {
-                        board.type = rpipicow;
-                    } else if(buffer[3] == "adafruitItsyRP2040") {
-                        board.type = adafruitItsyRP2040;
-                    } else if(buffer[3] == "adafruitKB2040") {
-                        board.type = adafruitKB2040;
-                    } else if(buffer[3] == "arduinoNanoRP2040") {
-                        board.type = arduinoNanoRP2040;
-                    } else if(buffer[3] == "waveshareZero") {
-                        board.type = waveshareZero;
-                    } else if(buffer[3] == "vccgndYD") {
-                        board.type = vccgndYD;
-                    } else {
-                        board.type = generic;
-                    }
-                    board.selectedProfile = buffer[4].toInt();
-                    board.previousProfile = board.selectedProfile;
-                    selectedProfile[board.selectedProfile]->setChecked(true);
-                    serialPort.write("Xli");
-                    serialPort.waitForReadyRead(1000);
-                    bufStr = serialPort.readLine().trimmed();
-                    buffer = bufStr.split(',');
-                    tinyUSBtable.tinyUSBid = buffer[0];
-                    tinyUSBtable_orig.tinyUSBid = tinyUSBtable.tinyUSBid;
-                    if(buffer[1] == "SERIALREADERR01") {
-                        tinyUSBtable.tinyUSBname = "";
-                    } else {
-                        tinyUSBtable.tinyUSBname = buffer[1];
-                    }
-                    tinyUSBtable_orig.tinyUSBname = tinyUSBtable.tinyUSBname;
-                    SerialLoad();
-                    return true;
-                } else if(buffer[0].contains("Device not available")) {
-                    PopupWindow("Camera not available!", "Device was detected, but data received indicates that the camera is in a bad state.\nThis can happen if the camera wires are crossed (data wire to clock pin, clock wire to data pin).\n\nThe camera must be removed or resoldered to resolve this.", "Device Error!", 3);
-                    return false;
-                } else {
-                    qDebug() << "Port did not respond with expected response! Seong fucked this up again.";
-                    return false;
-                }
-            } else {
-                PopupWindow("Data hasn't arrived! (Stale state?)", "Device was detected, but initial settings request wasn't received in time!\nThis can happen if the app was unexpectedly closed and the gun is in a stale docked state.\n\nTry selecting the device again.", "Sync Error!", 3);
-                qDebug() << "Didn't receive any data in time! Dammit Seong, you jiggled the cable too much again!";
-                return false;
-            }
-        } else {
+        gunReplies_s replies;
+        switch(gunConfig::Query(serialPort, replies)) {
+        case queryOk:
+            qDebug() << "OpenFIRE gun detected!";
+            SerialLoad(replies);
+            return true;
+        case queryNoCamera:
+            Notify("Camera not available!", "Device was detected, but data received indicates that the camera is in a bad state.\nThis can happen if the camera wires are crossed (data wire to clock pin, clock wire to data pin).\n\nThe camera must be removed or resoldered to resolve this.", notifyWarning);
+            return false;
+        case queryNotOpenFIRE:
+            qDebug() << "Port did not respond with expected response! Seong fucked this up again.";
+            return false;
+        case queryNoReply:
+            Notify("Data hasn't arrived! (Stale state?)", "Device was detected, but initial settings request wasn't received in time!\nThis can happen if the app was unexpectedly closed and the gun is in a stale docked state.\n\nTry selecting the device again.", notifyWarning);
+            qDebug() << "Didn't receive any data in time! Dammit Seong, you jiggled the cable too much again!";
+            return false;
+        case queryNoWrite:
             qDebug() << "Couldn't send any data in time! Does the port even exist??? Fucking dammit Seong!?!?!?";
             return false;
         }
+        return false;
     } else {
-        PopupWindow("Serial port is blocked!", "This usually indicates that the port is being used by something else, e.g. Arduino IDE's serial monitor, or another command line app (stty, screen).\n\nPlease close the offending application and try selecting this port again.", "Port In Use!", 3);
+        ServiceHandBack();
+        Notify("Serial port is blocked!", "This usually indicates that the port is being used by something else, e.g. Arduino IDE's serial monitor, or another command line app (stty, screen).\n\nPlease close the offending application and try selecting this port again.", notifyWarning);
         return false;
     }
 }
 
 
+// Gives a port we borrowed from the background service back to it, if any.
+void guiWindow::ServiceHandBack()
+{
+    if(!servicePort.isEmpty()) {
+        gunService::RequestPort(servicePort, false);
+        servicePort.clear();
+    }
+}
+
+
 void guiWindow::BoxesUpdate()
 {
     if(boolSettings[customPins]) {
         // if the custom pins setting grabbed from the gun has been set
         if(boolSettings_orig[customPins]) {
-            // clear map
-            currentPins.clear();
-            // set or clear the local pins mapping
-            for(uint8_t i = 0; i < 30; i++) {
-                currentPins[i] = btnUnmapped;
-            }
             // (re)-copy pins settings grabbed from the gun to the app catalog
             inputsMap = inputsMap_orig;
         // else, if the board was using default maps before switching to custom
         } else {
-            for(uint8_t i = 0; i < 30; i++) {
-                if(currentPins[i] > btnUnmapped) {
-                    inputsMap[currentPins[i]-1] = i;
-                }
+            PinsReindex();
+        }
+        // clear the local pins mapping; the boxes are pooled, so whatever the last gun had on them goes too.
+        currentPins.fill(btnUnmapped);
+        pinsMapped.reset();
+        for(uint8_t i = 0; i < boardInputsCount-1; i++) {
+            int8_t pin = inputsMap[i];
+            if(pin >= 0) {
+                currentPins[pin] = i+1;
+                pinsMapped.set(pin);
             }
         }
         // enable pinboxes
         for(uint8_t i = 0; i < 30; i++) {
             pinBoxes[i]->setEnabled(true);
-        }
-        for(uint8_t i = 0; i < boardInputsCount-1; i++) {
-            if(inputsMap.value(i) >= 0) {
-                currentPins[inputsMap.value(i)] = i+1;
-                pinBoxes[inputsMap.value(i)]->setCurrentIndex(currentPins[inputsMap.value(i)]);
-                pinBoxesOldIndex[inputsMap.value(i)] = currentPins[inputsMap.value(i)];
-            }
+            pinBoxes[i]->setCurrentIndex(currentPins[i]);
+            pinBoxesOldIndex[i] = currentPins[i];
         }
         return;
     } else {
-        switch(board.type) {
-        // pico and w are the same physical board, so why need a new layout for it?
-        case rpipico:
-        case rpipicow:
-        {
-            for(uint8_t i = 0; i < 30; i++) { currentPins[i] = rpipicoLayout[i].pinAssignment; }
-            break;
-        }
-        case adafruitItsyRP2040:
-        {
-            for(uint8_t i = 0; i < 30; i++) { currentPins[i] = adafruitItsyRP2040Layout[i].pinAssignment; }
-            break;
-        }
-        case adafruitKB2040:
-        {
-            for(uint8_t i = 0; i < 30; i++) { currentPins[i] = adafruitKB2040Layout[i].pinAssignment; }
-            break;
-        }
-        case arduinoNanoRP2040:
-        {
-            for(uint8_t i = 0; i < 30; i++) { currentPins[i] = arduinoNanoRP2040Layout[i].pinAssignment; }
-            break;
-        }
-        case waveshareZero:
-        {
-            for(uint8_t i = 0; i < 30; i++) { currentPins[i] = waveshareZeroLayout[i].pinAssignment; }
-            break;
-        }
+        const boardLayout_s *layout = BoardDesc(board.type).layout;
+        for(uint8_t i = 0; i < 30; i++) {
+            currentPins[i] = layout[i].pinAssignment;
         }
 
         for(uint8_t i = 0; i < 30; i++) {
@@ -572,114 +585,266 @@ void guiWindow::BoxesUpdate()
             pinBoxesOldIndex[i] = currentPins[i];
             pinBoxes[i]->setEnabled(false);
         }
-        for(uint8_t i = 0; i < 30; i++) {
-            if(currentPins[i] > btnUnmapped) {
-                inputsMap[currentPins[i]-1] = i;
-            }
-        }
+        PinsReindex();
     }
 }
 
 
-void guiWindow::DiffUpdate()
+// Rebuilds the reverse index and mapped set after currentPins gets rewritten wholesale.
+void guiWindow::PinsReindex()
 {
-    settingsDiff = 0;
-    if(boolSettings_orig[customPins] != boolSettings[customPins]) {
-        settingsDiff++;
-    }
-    if(boolSettings[customPins]) {
-        if(inputsMap_orig != inputsMap) {
-            settingsDiff++;
+    inputsMap.fill(-1);
+    pinsMapped.reset();
+    for(uint8_t i = 0; i < 30; i++) {
+        if(currentPins[i] > btnUnmapped) {
+            inputsMap[currentPins[i]-1] = i;
+            pinsMapped.set(i);
         }
     }
-    for(uint8_t i = 1; i < boolTypesCount; i++) {
-        if(boolSettings_orig[i] != boolSettings[i]) {
-            settingsDiff++;
-        }
+}
+
+
+// Puts the working pin map on the boxes as it is, unlike BoxesUpdate() which starts over from the gun's.
+void guiWindow::PinsShow()
+{
+    if(!boolSettings[customPins]) {
+        // default layout, nothing to keep.
+        BoxesUpdate();
+        return;
     }
-    for(uint8_t i = 0; i < settingsTypesCount; i++) {
-        if(settingsTable_orig[i] != settingsTable[i]) {
-            settingsDiff++;
+    currentPins.fill(btnUnmapped);
+    for(uint8_t i = 0; i < boardInputsCount-1; i++) {
+        if(inputsMap[i] >= 0) {
+            currentPins[inputsMap[i]] = i+1;
         }
     }
-    if(tinyUSBtable_orig.tinyUSBid != tinyUSBtable.tinyUSBid) {
-        settingsDiff++;
+    for(uint8_t i = 0; i < 30; i++) {
+        pinBoxes[i]->setEnabled(true);
+        pinBoxes[i]->setCurrentIndex(currentPins[i]);
+        pinBoxesOldIndex[i] = currentPins[i];
     }
-    if(tinyUSBtable_orig.tinyUSBname != tinyUSBtable.tinyUSBname) {
-        settingsDiff++;
+    PinsReindex();
+    if(inputsMap[neoPixel-1] >= 0) { ui->neopixelGroupBox->setEnabled(true); } else { ui->neopixelGroupBox->setEnabled(false); }
+}
+
+
+// Packs either the working copy of the config, or the one as loaded from the gun.
+packedConfig_s guiWindow::PackConfig(bool loaded)
+{
+    if(loaded) {
+        return configDiff::Pack(boolSettings_orig, inputsMap_orig.data(), settingsTable_orig, tinyUSBtable_orig, board.previousProfile, profilesTable_orig);
+    } else {
+        return configDiff::Pack(boolSettings, inputsMap.data(), settingsTable, tinyUSBtable, board.selectedProfile, profilesTable);
     }
-    if(board.selectedProfile != board.previousProfile) {
-        settingsDiff++;
+}
+
+
+// Full rescan, for when lots changes at once (loading, saving, switching pin layouts).
+void guiWindow::DiffUpdate()
+{
+    dirtyFields = configDiff::Compare(PackConfig(true), PackConfig(false));
+    DirtyRefresh();
+    HistoryRecord(-1);
+}
+
+
+guiWindow::bulkApply::bulkApply(guiWindow *window)
+    : window(window)
+{
+    if(window->bulkDepth++ > 0) {
+        return;
     }
-    for(uint8_t i = 0; i < PROFILES_COUNT; i++) {
-        if(profilesTable_orig[i].profName != profilesTable[i].profName) {
-            settingsDiff++;
-        }
-        if(profilesTable_orig[i].topOffset != profilesTable[i].topOffset) {
-            settingsDiff++;
-        }
-        if(profilesTable_orig[i].bottomOffset != profilesTable[i].bottomOffset) {
-            settingsDiff++;
-        }
-        if(profilesTable_orig[i].leftOffset != profilesTable[i].leftOffset) {
-            settingsDiff++;
+    window->setUpdatesEnabled(false);
+    for(QWidget *widget : window->ui->tabWidget->findChildren<QWidget*>()) {
+        // only the things with handlers hooked up; spinboxes' own line edits are left alone.
+        if(!qobject_cast<QAbstractButton*>(widget) && !qobject_cast<QAbstractSpinBox*>(widget) &&
+           !qobject_cast<QComboBox*>(widget) && !qobject_cast<QLineEdit*>(widget)) {
+            continue;
         }
-        if(profilesTable_orig[i].rightOffset != profilesTable[i].rightOffset) {
-            settingsDiff++;
+        if(qobject_cast<QAbstractSpinBox*>(widget->parentWidget()) || widget->signalsBlocked()) {
+            continue;
         }
-        if(profilesTable_orig[i].TLled != profilesTable[i].TLled) {
-            settingsDiff++;
-        }
-        if(profilesTable_orig[i].TRled != profilesTable[i].TRled) {
-            settingsDiff++;
-        }
-        if(profilesTable_orig[i].irSensitivity != profilesTable[i].irSensitivity) {
-            settingsDiff++;
-        }
-        if(profilesTable_orig[i].runMode != profilesTable[i].runMode) {
-            settingsDiff++;
-        }
-        if(profilesTable_orig[i].layoutType != profilesTable[i].layoutType) {
-            settingsDiff++;
-        }
-        if(profilesTable_orig[i].color != profilesTable[i].color) {
-            settingsDiff++;
-        }
-    }
-    if(settingsDiff) {
-        ui->confirmButton->setText("Save and Send Settings");
-        ui->confirmButton->setEnabled(true);
-    } else {
-        ui->confirmButton->setText("[Nothing To Save]");
-        ui->confirmButton->setEnabled(false);
+        widget->blockSignals(true);
+        blocked.append(widget);
     }
 }
 
 
-void guiWindow::SyncSettings()
+guiWindow::bulkApply::~bulkApply()
 {
-    for(uint8_t i = 0; i < boolTypesCount; i++) {
-        boolSettings_orig[i] = boolSettings[i];
-    }
-    if(boolSettings_orig[customPins]) {
-        inputsMap_orig = inputsMap;
-    } else {
-        for(uint8_t i = 0; i < boardInputsCount-1; i++)
-        inputsMap_orig[i] = -1;
+    if(--window->bulkDepth > 0) {
+        return;
     }
-    for(uint8_t i = 0; i < settingsTypesCount; i++) {
-        settingsTable_orig[i] = settingsTable[i];
+    for(QWidget *widget : blocked) {
+        widget->blockSignals(false);
     }
-    tinyUSBtable_orig.tinyUSBid = tinyUSBtable.tinyUSBid;
+    window->BulkCommit();
+    window->setUpdatesEnabled(true);
+}
+
+
+// What the handlers blocked by bulkApply would've done, just the once.
+void guiWindow::BulkCommit()
+{
+    ui->rumbleFFToggle->setEnabled(boolSettings[rumble]);
+    on_customLEDstaticSpinbox_valueChanged(ui->customLEDstaticSpinbox->value());
+    on_productIdInput_textChanged(ui->productIdInput->text());
+    // and a single rescan for the lot.
+    DiffUpdate();
+}
+
+
+void guiWindow::DirtyRefresh()
+{
+    static const configDiff_t pinsMask = configDiff::PinsMask();
+    // the pins map only counts if it's actually going to be sent.
+    if(boolSettings[customPins]) {
+        settingsDiff = dirtyFields.count();
+    } else {
+        settingsDiff = (dirtyFields & ~pinsMask).count();
+    }
+    if(settingsDiff) {
+        ui->confirmButton->setText("Save and Send Settings");
+        ui->confirmButton->setEnabled(true);
+    } else {
+        ui->confirmButton->setText("[Nothing To Save]");
+        ui->confirmButton->setEnabled(false);
+    }
+}
+
+
+void guiWindow::DirtyMark(uint16_t field, bool dirty)
+{
+    dirtyFields.set(field, dirty);
+    DirtyRefresh();
+    HistoryRecord(field);
+}
+
+// Field setters: every single edit goes through one of these,
+// which checks just that field against the board's copy.
+void guiWindow::BoolSet(uint8_t type, bool value)
+{
+    boolSettings[type] = value;
+    DirtyMark(packedBools + type, value != boolSettings_orig[type]);
+}
+
+
+void guiWindow::InputSet(uint8_t input, int8_t pin)
+{
+    inputsMap[input] = pin;
+    DirtyMark(packedPins + input, pin != inputsMap_orig[input]);
+}
+
+
+void guiWindow::SettingSet(uint8_t type, uint32_t value)
+{
+    settingsTable[type] = SettingClamp(type, value);
+    DirtyMark(packedSettings + type, settingsTable[type] != settingsTable_orig[type]);
+}
+
+
+// Hooks up every settings widget named in settingsSchema, with its range from there too.
+void guiWindow::SettingsBind()
+{
+    for(uint8_t i = 0; i < settingsTypesCount; i++) {
+        const settingSchema_s &setting = settingsSchema[i];
+        if(setting.kind == settingNumber) {
+            QSpinBox *box = findChild<QSpinBox*>(setting.widget);
+            box->setRange(setting.min, setting.max);
+            connect(box, SIGNAL(valueChanged(int)), this, SLOT(settingBoxes_valueChanged(int)));
+        } else if(setting.kind == settingColor) {
+            connect(findChild<QPushButton*>(setting.widget), SIGNAL(clicked()), this, SLOT(settingButtons_clicked()));
+        }
+    }
+}
+
+
+// Puts settingsTable into the widgets bound above.
+void guiWindow::SettingsShow()
+{
+    for(uint8_t i = 0; i < settingsTypesCount; i++) {
+        const settingSchema_s &setting = settingsSchema[i];
+        if(setting.kind == settingNumber) {
+            findChild<QSpinBox*>(setting.widget)->setValue(settingsTable[i]);
+        } else if(setting.kind == settingColor) {
+            findChild<QPushButton*>(setting.widget)->setStyleSheet(QString("background-color: #%1").arg(settingsTable[i], 6, 16, QLatin1Char('0')));
+        }
+    }
+}
+
+
+void guiWindow::TinyUSBSet(const QString &id, const QString &name)
+{
+    tinyUSBtable.tinyUSBid = id;
+    tinyUSBtable.tinyUSBname = name;
+    dirtyFields.set(packedTinyUSBid, id != tinyUSBtable_orig.tinyUSBid);
+    DirtyMark(packedTinyUSBname, name != tinyUSBtable_orig.tinyUSBname);
+}
+
+
+void guiWindow::SelectedProfileSet(uint8_t slot)
+{
+    board.selectedProfile = slot;
+    DirtyMark(packedSelectedProfile, slot != board.previousProfile);
+    if(profilesTableModel) {
+        profilesTableModel->SelectedChanged(slot);
+    }
+}
+
+
+void guiWindow::ProfileSet(uint8_t slot, uint8_t field, uint32_t value)
+{
+    profilesTable_s &profile = profilesTable[slot];
+    const profilesTable_s &orig = profilesTable_orig[slot];
+    bool dirty = false;
+    switch(field) {
+    case profTopOffset:     profile.topOffset = value;     dirty = profile.topOffset != orig.topOffset; break;
+    case profBottomOffset:  profile.bottomOffset = value;  dirty = profile.bottomOffset != orig.bottomOffset; break;
+    case profLeftOffset:    profile.leftOffset = value;    dirty = profile.leftOffset != orig.leftOffset; break;
+    case profRightOffset:   profile.rightOffset = value;   dirty = profile.rightOffset != orig.rightOffset; break;
+    case profTLled:         profile.TLled = value;         dirty = profile.TLled != orig.TLled; break;
+    case profTRled:         profile.TRled = value;         dirty = profile.TRled != orig.TRled; break;
+    case profIrSensitivity: profile.irSensitivity = value; dirty = profile.irSensitivity != orig.irSensitivity; break;
+    case profRunMode:       profile.runMode = value;       dirty = profile.runMode != orig.runMode; break;
+    case profLayoutType:    profile.layoutType = value;    dirty = profile.layoutType != orig.layoutType; break;
+    case profColor:         profile.color = value;         dirty = profile.color != orig.color; break;
+    default:                return;
+    }
+    DirtyMark(packedProfiles + slot * profileFieldsCount + field, dirty);
+    if(profilesTableModel) {
+        profilesTableModel->FieldChanged(slot, field);
+    }
+}
+
+
+void guiWindow::ProfileNameSet(uint8_t slot, const QString &name)
+{
+    profilesTable[slot].profName = name;
+    DirtyMark(packedProfiles + slot * profileFieldsCount + profName, name != profilesTable_orig[slot].profName);
+    if(profilesTableModel) {
+        profilesTableModel->FieldChanged(slot, profName);
+    }
+}
+
+
+void guiWindow::SyncSettings()
+{
+    for(uint8_t i = 0; i < boolTypesCount; i++) {
+        boolSettings_orig[i] = boolSettings[i];
+    }
+    if(boolSettings_orig[customPins]) {
+        inputsMap_orig = inputsMap;
+    } else {
+        inputsMap_orig.fill(-1);
+    }
+    for(uint8_t i = 0; i < settingsTypesCount; i++) {
+        settingsTable_orig[i] = settingsTable[i];
+    }
+    tinyUSBtable_orig.tinyUSBid = tinyUSBtable.tinyUSBid;
     tinyUSBtable_orig.tinyUSBname = tinyUSBtable.tinyUSBname;
     board.previousProfile = board.selectedProfile;
-    for(uint8_t i = 0; i < PROFILES_COUNT; i++) {
-        profilesTable_orig[i].irSensitivity = profilesTable[i].irSensitivity;
-        profilesTable_orig[i].runMode = profilesTable[i].runMode;
-        profilesTable_orig[i].layoutType = profilesTable[i].layoutType;
-        profilesTable_orig[i].color = profilesTable[i].color;
-        profilesTable_orig[i].profName = profilesTable[i].profName;
-    }
+    // XS commits calibration results along with everything else, so take the lot.
+    profilesTable_orig = profilesTable;
     LabelsUpdate();
 }
 
@@ -692,31 +857,10 @@ QString PrettifyName()
     } else {
         name = "Unnamed Device";
     }
-    switch(board.type) {
-    case nothing:
+    if(board.type == nothing) {
         name = "";
-        break;
-    case rpipico:
-        name = name + " | Raspberry Pi Pico";
-        break;
-    case rpipicow:
-        name = name + " | Raspberry Pi Pico W";
-        break;
-    case adafruitItsyRP2040:
-        name = name + " | Adafruit ItsyBitsy RP2040";
-        break;
-    case adafruitKB2040:
-        name = name + " | Adafruit KB2040";
-        break;
-    case arduinoNanoRP2040:
-        name = name + " | Arduino Nano RP2040 Connect";
-        break;
-    case waveshareZero:
-        name = name + " | Waveshare RP2040 Zero";
-        break;
-    case generic:
-        name = name + " | Generic RP2040 Board";
-        break;
+    } else {
+        name = name + " | " + BoardDesc(board.type).displayName;
     }
     return name;
 }
@@ -724,111 +868,131 @@ QString PrettifyName()
 
 void guiWindow::on_confirmButton_clicked()
 {
-    QMessageBox messageBox;
-    messageBox.setText("Are these settings okay?");
-    messageBox.setInformativeText("These settings will be committed to your lightgun. Is that okay?");
-    messageBox.setWindowTitle("Commit Confirmation");
-    messageBox.setIcon(QMessageBox::Information);
-    messageBox.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
-    messageBox.setDefaultButton(QMessageBox::Yes);
-    int value = messageBox.exec();
-    if(value == QMessageBox::Yes) {
-        if(serialPort.isOpen()) {
-            serialActive = true;
-            aliveTimer->stop();
-            // send a signal so the gun pauses its test outputs for the save op.
-            serialPort.write("Xm");
-            serialPort.waitForBytesWritten(1000);
-
-            QProgressBar *statusProgressBar = new QProgressBar();
-            ui->statusBar->addPermanentWidget(statusProgressBar);
-            ui->tabWidget->setEnabled(false);
-            ui->comPortSelector->setEnabled(false);
-            ui->confirmButton->setEnabled(false);
+    Confirm("Are these settings okay?", "These settings will be committed to your lightgun. Is that okay?", "Commit Confirmation", notifyInfo,
+            [this]() { ConfigCommit(); },
+            [this]() { statusBar()->showMessage("Save operation canceled.", 3000); });
+}
+
+
+void guiWindow::ConfigCommit()
+{
+    if(serialPort.isOpen()) {
+        serialActive = true;
+        aliveTimer->stop();
+        // send a signal so the gun pauses its test outputs for the save op.
+        serialPort.write("Xm");
+        serialPort.waitForBytesWritten(1000);
+
+        QProgressBar *statusProgressBar = new QProgressBar();
+        ui->statusBar->addPermanentWidget(statusProgressBar);
+        ui->tabWidget->setEnabled(false);
+        ui->comPortSelector->setEnabled(false);
+        ui->confirmButton->setEnabled(false);
 
-            QStringList serialQueue;
-            for(uint8_t i = 0; i < boolTypesCount; i++) {
+        // Only send what's actually changed.
+        QStringList serialQueue;
+        for(uint8_t i = 0; i < boolTypesCount; i++) {
+            if(dirtyFields.test(packedBools + i)) {
                 serialQueue.append(QString("Xm.0.%1.%2").arg(i).arg(boolSettings[i]));
             }
+        }
 
-            if(boolSettings[customPins]) {
-                for(uint8_t i = 0; i < boardInputsCount-1; i++) {
-                    serialQueue.append(QString("Xm.1.%1.%2").arg(i).arg(inputsMap.value(i)));
+        if(boolSettings[customPins]) {
+            for(uint8_t i = 0; i < boardInputsCount-1; i++) {
+                // we never read the board's pin map if it wasn't using it, so send the whole thing then.
+                if(!boolSettings_orig[customPins] || dirtyFields.test(packedPins + i)) {
+                    serialQueue.append(QString("Xm.1.%1.%2").arg(i).arg(inputsMap[i]));
                 }
             }
+        }
 
-            for(uint8_t i = 0; i < settingsTypesCount; i++) {
-                serialQueue.append(QString("Xm.2.%1.%2").arg(i).arg(settingsTable[i]));
+        for(uint8_t i = 0; i < settingsTypesCount; i++) {
+            if(dirtyFields.test(packedSettings + i)) {
+                serialQueue.append(QString("Xm.2.%1.%2").arg(settingsSchema[i].id).arg(settingsTable[i]));
             }
+        }
 
+        if(dirtyFields.test(packedTinyUSBid)) {
             serialQueue.append(QString("Xm.3.0.%1").arg(tinyUSBtable.tinyUSBid));
-            if(!tinyUSBtable.tinyUSBname.isEmpty()) {
-                serialQueue.append(QString("Xm.3.1.%1").arg(tinyUSBtable.tinyUSBname));
-            }
-            for(uint8_t i = 0; i < 4; i++) {
+        }
+        if(dirtyFields.test(packedTinyUSBname) && !tinyUSBtable.tinyUSBname.isEmpty()) {
+            serialQueue.append(QString("Xm.3.1.%1").arg(tinyUSBtable.tinyUSBname));
+        }
+        for(uint8_t i = 0; i < profilesTable.length(); i++) {
+            uint16_t prof = packedProfiles + i * profileFieldsCount;
+            if(dirtyFields.test(prof + profIrSensitivity)) {
                 serialQueue.append(QString("Xm.P.i.%1.%2").arg(i).arg(profilesTable[i].irSensitivity));
+            }
+            if(dirtyFields.test(prof + profRunMode)) {
                 serialQueue.append(QString("Xm.P.r.%1.%2").arg(i).arg(profilesTable[i].runMode));
+            }
+            if(dirtyFields.test(prof + profLayoutType)) {
                 serialQueue.append(QString("Xm.P.l.%1.%2").arg(i).arg(profilesTable[i].layoutType));
+            }
+            if(dirtyFields.test(prof + profColor)) {
                 serialQueue.append(QString("Xm.P.c.%1.%2").arg(i).arg(profilesTable[i].color));
+            }
+            if(dirtyFields.test(prof + profName)) {
                 serialQueue.append(QString("Xm.P.n.%1.%2").arg(i).arg(profilesTable[i].profName));
             }
-            serialQueue.append("XS");
+        }
+        serialQueue.append("XS");
 
-            statusProgressBar->setRange(0, serialQueue.length()-1);
-            bool success = true;
+        statusProgressBar->setRange(0, serialQueue.length()-1);
+        bool success = true;
 
-            // throw out whatever's in the buffer if there's anything there.
-            while(!serialPort.atEnd()) {
-                serialPort.readLine();
-            }
+        // throw out whatever's in the buffer if there's anything there.
+        while(!serialPort.atEnd()) {
+            serialPort.readLine();
+        }
 
-            for(uint8_t i = 0; i < serialQueue.length(); i++) {
-                serialPort.write(serialQueue[i].toLocal8Bit());
-                serialPort.waitForBytesWritten(2000);
-                if(serialPort.waitForReadyRead(2000)) {
-                    QString buffer = serialPort.readLine();
-                    if(buffer.contains("OK:") || buffer.contains("NOENT:")) {
-                        statusProgressBar->setValue(statusProgressBar->value() + 1);
-                    } else if(i == serialQueue.length() - 1 && buffer.contains("Saving preferences...")) {
-                        for(uint8_t t = 0; t < 3; t++) {
-                            if(serialPort.atEnd()) { serialPort.waitForReadyRead(2000); }
-                            buffer = serialPort.readLine();
-                            if(buffer.contains("Settings saved to")) {
-                                success = true;
-                                t = 3;
-                            }
+        for(uint8_t i = 0; i < serialQueue.length(); i++) {
+            serialPort.write(serialQueue[i].toLocal8Bit());
+            serialPort.waitForBytesWritten(2000);
+            if(serialPort.waitForReadyRead(2000)) {
+                QString buffer = serialPort.readLine();
+                if(buffer.contains("OK:") || buffer.contains("NOENT:")) {
+                    statusProgressBar->setValue(statusProgressBar->value() + 1);
+                } else if(i == serialQueue.length() - 1 && buffer.contains("Saving preferences...")) {
+                    for(uint8_t t = 0; t < 3; t++) {
+                        if(serialPort.atEnd()) { serialPort.waitForReadyRead(2000); }
+                        buffer = serialPort.readLine();
+                        if(buffer.contains("Settings saved to")) {
+                            success = true;
+                            t = 3;
                         }
-                        if(success) {
-                            while(!serialPort.atEnd()) {
-                                serialPort.readLine();
-                            }
+                    }
+                    if(success) {
+                        while(!serialPort.atEnd()) {
+                            serialPort.readLine();
                         }
                     }
                 }
             }
-            ui->statusBar->removeWidget(statusProgressBar);
-            delete statusProgressBar;
-            ui->tabWidget->setEnabled(true);
-            ui->comPortSelector->setEnabled(true);
-            if(!success) {
-                qDebug() << "Ah shit, it failed! What did you do, Seong?";
-            } else {
-                statusBar()->showMessage("Sent settings successfully!", 5000);
-                SyncSettings();
-                DiffUpdate();
-                ui->boardLabel->setText(PrettifyName());
-            }
-            serialActive = false;
-            aliveTimer->start(ALIVE_TIMER);
-            serialQueue.clear();
-            if(!serialPort.atEnd()) {
-                serialPort.readAll();
-            }
+        }
+        ui->statusBar->removeWidget(statusProgressBar);
+        delete statusProgressBar;
+        ui->tabWidget->setEnabled(true);
+        ui->comPortSelector->setEnabled(true);
+        if(!success) {
+            qDebug() << "Ah shit, it failed! What did you do, Seong?";
         } else {
-            qDebug() << "Wait, this port wasn't open to begin with!!! WTF SEONG!?!?";
+            statusBar()->showMessage("Sent settings successfully!", 5000);
+            SyncSettings();
+            DiffUpdate();
+            ui->boardLabel->setText(PrettifyName());
+            // the gun has exactly what's here now.
+            loadedConfig = WorkingConfig();
+            ConfigStore(*loadedConfig, storeSaved);
+        }
+        serialActive = false;
+        aliveTimer->start(ALIVE_TIMER);
+        serialQueue.clear();
+        if(!serialPort.atEnd()) {
+            serialPort.readAll();
         }
     } else {
-        statusBar()->showMessage("Save operation canceled.", 3000);
+        qDebug() << "Wait, this port wasn't open to begin with!!! WTF SEONG!?!?";
     }
 }
 
@@ -840,6 +1004,7 @@ void guiWindow::aliveTimer_timeout()
         if(!serialPort.waitForBytesWritten(1)) {
             statusBar()->showMessage("Board hasn't responded to pulse; assuming it's been disconnected.");
             serialPort.close();
+            ServiceHandBack();
             ui->comPortSelector->setCurrentIndex(0);
         }
     }
@@ -848,43 +1013,11 @@ void guiWindow::aliveTimer_timeout()
 
 void guiWindow::on_comPortSelector_currentIndexChanged(int index)
 {
-    // Indiscriminately clears the board layout views.
-    // yes, every time. goddammit QT.
-    // fuck it, it works until QT provides a better mechanism to remove widgets without deleting them.
-    if(pinBoxes[0]->count() > 0) {
-        for(uint8_t i = 0; i < 30; i++) {
-            pinBoxes[i]->clear();
-            delete pinBoxes[i];
-            delete padding[i];
-            delete pinLabel[i];
-        }
-        delete centerPic;
+    // whatever the last port was still decoding isn't wanted anymore; loadThread_finished() will skip it.
+    if(loadThread) {
+        loadThread->wait();
+        loadThread = nullptr;
     }
-
-    delete PinsCenter;
-    delete PinsLeft;
-    delete PinsRight;
-
-    PinsCenter = new QVBoxLayout();
-    PinsCenterSub = new QGridLayout();
-    PinsLeft = new QGridLayout();
-    PinsRight = new QGridLayout();
-
-    ui->PinsTopHalf->addLayout(PinsLeft);
-    ui->PinsTopHalf->addLayout(PinsCenter);
-    ui->PinsTopHalf->addLayout(PinsRight);
-
-    for(uint8_t i = 0; i < 30; i++) {
-        pinBoxes[i] = new QComboBox();
-        pinBoxes[i]->setSizePolicy(QSizePolicy::Fixed,QSizePolicy::Fixed);
-        connect(pinBoxes[i], SIGNAL(activated(int)), this, SLOT(pinBoxes_activated(int)));
-        padding[i] = new QWidget();
-        padding[i]->setMinimumHeight(25);
-        pinLabel[i] = new QLabel(QString("<GPIO%1>").arg(i));
-        pinLabel[i]->setEnabled(false);
-        pinLabel[i]->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
-    }
-
     if(index > 0) {
         qDebug() << "COM port set to" << ui->comPortSelector->currentIndex();
         // Clear stale states if any, and unmount old board if mounted.
@@ -907,6 +1040,7 @@ void guiWindow::on_comPortSelector_currentIndexChanged(int index)
             serialPort.waitForReadyRead(2000);
             serialPort.readAll();
             serialPort.close();
+            ServiceHandBack();
             serialActive = false;
         }
         // try to init serial port
@@ -917,444 +1051,10 @@ void guiWindow::on_comPortSelector_currentIndexChanged(int index)
         // else, serial port is online! What do we got?
         } else {
             aliveTimer->start(ALIVE_TIMER);
-            ui->versionLabel->setText(QString("v%1 - \"%2\"").arg(board.versionNumber).arg(board.versionCodename));
-            BoxesFill();
-            LabelsUpdate();
-
-            switch(board.type) {
-                case rpipico:
-                {
-                    centerPic = new QSvgWidget(":/boardPics/pico.svg");
-                    QSvgRenderer *picRenderer = centerPic->renderer();
-                    picRenderer->setAspectRatioMode(Qt::KeepAspectRatio);
-                    ui->boardLabel->setText(PrettifyName());
-
-                    // left side
-                    PinsLeft->addWidget(padding[0],    0,  0);   // padding
-                    PinsLeft->addWidget(pinBoxes[0],   1,  0), PinsLeft->addWidget(pinLabel[0],  1,  1);
-                    PinsLeft->addWidget(pinBoxes[1],   2,  0), PinsLeft->addWidget(pinLabel[1],  2,  1);
-                    PinsLeft->addWidget(padding[1],    3,  0);   // gnd
-                    PinsLeft->addWidget(pinBoxes[2],   4,  0), PinsLeft->addWidget(pinLabel[2],  4,  1);
-                    PinsLeft->addWidget(pinBoxes[3],   5,  0), PinsLeft->addWidget(pinLabel[3],  5,  1);
-                    PinsLeft->addWidget(pinBoxes[4],   6,  0), PinsLeft->addWidget(pinLabel[4],  6,  1);
-                    PinsLeft->addWidget(pinBoxes[5],   7,  0), PinsLeft->addWidget(pinLabel[5],  7,  1);
-                    PinsLeft->addWidget(padding[2],    8,  0);   // gnd
-                    PinsLeft->addWidget(pinBoxes[6],   9,  0), PinsLeft->addWidget(pinLabel[6],  9,  1);
-                    PinsLeft->addWidget(pinBoxes[7],   10, 0), PinsLeft->addWidget(pinLabel[7],  10, 1);
-                    PinsLeft->addWidget(pinBoxes[8],   11, 0), PinsLeft->addWidget(pinLabel[8],  11, 1);
-                    PinsLeft->addWidget(pinBoxes[9],   12, 0), PinsLeft->addWidget(pinLabel[9],  12, 1);
-                    PinsLeft->addWidget(padding[3],    13, 0);   // gnd
-                    PinsLeft->addWidget(pinBoxes[10],  14, 0), PinsLeft->addWidget(pinLabel[10], 14, 1);
-                    PinsLeft->addWidget(pinBoxes[11],  15, 0), PinsLeft->addWidget(pinLabel[11], 15, 1);
-                    PinsLeft->addWidget(pinBoxes[12],  16, 0), PinsLeft->addWidget(pinLabel[12], 16, 1);
-                    PinsLeft->addWidget(pinBoxes[13],  17, 0), PinsLeft->addWidget(pinLabel[13], 17, 1);
-                    PinsLeft->addWidget(padding[4],    18, 0);   // gnd
-                    PinsLeft->addWidget(pinBoxes[14],  19, 0), PinsLeft->addWidget(pinLabel[14], 19, 1);
-                    PinsLeft->addWidget(pinBoxes[15],  20, 0), PinsLeft->addWidget(pinLabel[15], 20, 1);
-
-                    // right side
-                    PinsRight->addWidget(padding[5],   0,  1);   // padding
-                    PinsRight->addWidget(padding[6],   1,  1);   // VBUS
-                    PinsRight->addWidget(padding[7],   2,  1);   // VSYS
-                    PinsRight->addWidget(padding[8],   3,  1);   // gnd
-                    PinsRight->addWidget(padding[9],   4,  1);   // 3V3 EN
-                    PinsRight->addWidget(padding[10],  5,  1);   // 3V3 OUT
-                    PinsRight->addWidget(padding[11],  6,  1);   // ADC VREF
-                    PinsRight->addWidget(pinBoxes[28], 7,  1), PinsRight->addWidget(pinLabel[28], 7,  0);
-                    PinsRight->addWidget(padding[12],  8,  1);   // gnd
-                    PinsRight->addWidget(pinBoxes[27], 9,  1), PinsRight->addWidget(pinLabel[27], 9,  0);
-                    PinsRight->addWidget(pinBoxes[26], 10, 1), PinsRight->addWidget(pinLabel[26], 10, 0);
-                    PinsRight->addWidget(padding[13],  11, 1);   // RUN
-                    PinsRight->addWidget(pinBoxes[22], 12, 1), PinsRight->addWidget(pinLabel[22], 12, 0);
-                    PinsRight->addWidget(padding[14],  13, 1);   // gnd
-                    PinsRight->addWidget(pinBoxes[21], 14, 1), PinsRight->addWidget(pinLabel[21], 14, 0);
-                    PinsRight->addWidget(pinBoxes[20], 15, 1), PinsRight->addWidget(pinLabel[20], 15, 0);
-                    PinsRight->addWidget(pinBoxes[19], 16, 1), PinsRight->addWidget(pinLabel[19], 16, 0);
-                    PinsRight->addWidget(pinBoxes[18], 17, 1), PinsRight->addWidget(pinLabel[18], 17, 0);
-                    PinsRight->addWidget(padding[17],  18, 1);   // gnd
-                    PinsRight->addWidget(pinBoxes[17], 19, 1), PinsRight->addWidget(pinLabel[17], 19, 0);
-                    PinsRight->addWidget(pinBoxes[16], 20, 1), PinsRight->addWidget(pinLabel[16], 20, 0);
-
-                    // center
-                    PinsCenter->addWidget(centerPic);
-                    centerPic->setSizePolicy(QSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding));
-                    break;
-                }
-                case rpipicow:
-                {
-                    centerPic = new QSvgWidget(":/boardPics/picow.svg");
-                    QSvgRenderer *picRenderer = centerPic->renderer();
-                    picRenderer->setAspectRatioMode(Qt::KeepAspectRatio);
-                    ui->boardLabel->setText(PrettifyName());
-
-                    // left side
-                    PinsLeft->addWidget(padding[0],    0,  0);   // padding
-                    PinsLeft->addWidget(pinBoxes[0],   1,  0), PinsLeft->addWidget(pinLabel[0],  1,  1);
-                    PinsLeft->addWidget(pinBoxes[1],   2,  0), PinsLeft->addWidget(pinLabel[1],  2,  1);
-                    PinsLeft->addWidget(padding[1],    3,  0);   // gnd
-                    PinsLeft->addWidget(pinBoxes[2],   4,  0), PinsLeft->addWidget(pinLabel[2],  4,  1);
-                    PinsLeft->addWidget(pinBoxes[3],   5,  0), PinsLeft->addWidget(pinLabel[3],  5,  1);
-                    PinsLeft->addWidget(pinBoxes[4],   6,  0), PinsLeft->addWidget(pinLabel[4],  6,  1);
-                    PinsLeft->addWidget(pinBoxes[5],   7,  0), PinsLeft->addWidget(pinLabel[5],  7,  1);
-                    PinsLeft->addWidget(padding[2],    8,  0);   // gnd
-                    PinsLeft->addWidget(pinBoxes[6],   9,  0), PinsLeft->addWidget(pinLabel[6],  9,  1);
-                    PinsLeft->addWidget(pinBoxes[7],   10, 0), PinsLeft->addWidget(pinLabel[7],  10, 1);
-                    PinsLeft->addWidget(pinBoxes[8],   11, 0), PinsLeft->addWidget(pinLabel[8],  11, 1);
-                    PinsLeft->addWidget(pinBoxes[9],   12, 0), PinsLeft->addWidget(pinLabel[9],  12, 1);
-                    PinsLeft->addWidget(padding[3],    13, 0);   // gnd
-                    PinsLeft->addWidget(pinBoxes[10],  14, 0), PinsLeft->addWidget(pinLabel[10], 14, 1);
-                    PinsLeft->addWidget(pinBoxes[11],  15, 0), PinsLeft->addWidget(pinLabel[11], 15, 1);
-                    PinsLeft->addWidget(pinBoxes[12],  16, 0), PinsLeft->addWidget(pinLabel[12], 16, 1);
-                    PinsLeft->addWidget(pinBoxes[13],  17, 0), PinsLeft->addWidget(pinLabel[13], 17, 1);
-                    PinsLeft->addWidget(padding[4],    18, 0);   // gnd
-                    PinsLeft->addWidget(pinBoxes[14],  19, 0), PinsLeft->addWidget(pinLabel[14], 19, 1);
-                    PinsLeft->addWidget(pinBoxes[15],  20, 0), PinsLeft->addWidget(pinLabel[15], 20, 1);
-
-                    // right side
-                    PinsRight->addWidget(padding[5],   0,  1);   // padding
-                    PinsRight->addWidget(padding[6],   1,  1);   // VBUS
-                    PinsRight->addWidget(padding[7],   2,  1);   // VSYS
-                    PinsRight->addWidget(padding[8],   3,  1);   // gnd
-                    PinsRight->addWidget(padding[9],   4,  1);   // 3V3 EN
-                    PinsRight->addWidget(padding[10],  5,  1);   // 3V3 OUT
-                    PinsRight->addWidget(padding[11],  6,  1);   // ADC VREF
-                    PinsRight->addWidget(pinBoxes[28], 7,  1), PinsRight->addWidget(pinLabel[28], 7,  0);
-                    PinsRight->addWidget(padding[12],  8,  1);   // gnd
-                    PinsRight->addWidget(pinBoxes[27], 9,  1), PinsRight->addWidget(pinLabel[27], 9,  0);
-                    PinsRight->addWidget(pinBoxes[26], 10, 1), PinsRight->addWidget(pinLabel[26], 10, 0);
-                    PinsRight->addWidget(padding[13],  11, 1);   // RUN
-                    PinsRight->addWidget(pinBoxes[22], 12, 1), PinsRight->addWidget(pinLabel[22], 12, 0);
-                    PinsRight->addWidget(padding[14],  13, 1);   // gnd
-                    PinsRight->addWidget(pinBoxes[21], 14, 1), PinsRight->addWidget(pinLabel[21], 14, 0);
-                    PinsRight->addWidget(pinBoxes[20], 15, 1), PinsRight->addWidget(pinLabel[20], 15, 0);
-                    PinsRight->addWidget(pinBoxes[19], 16, 1), PinsRight->addWidget(pinLabel[19], 16, 0);
-                    PinsRight->addWidget(pinBoxes[18], 17, 1), PinsRight->addWidget(pinLabel[18], 17, 0);
-                    PinsRight->addWidget(padding[17],  18, 1);   // gnd
-                    PinsRight->addWidget(pinBoxes[17], 19, 1), PinsRight->addWidget(pinLabel[17], 19, 0);
-                    PinsRight->addWidget(pinBoxes[16], 20, 1), PinsRight->addWidget(pinLabel[16], 20, 0);
-
-                    // center
-                    PinsCenter->addWidget(centerPic);
-                    centerPic->setSizePolicy(QSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding));
-                    break;
-                }
-                case adafruitItsyRP2040:
-                {
-                    centerPic = new QSvgWidget(":/boardPics/adafruitItsy2040.svg");
-                    QSvgRenderer *picRenderer = centerPic->renderer();
-                    picRenderer->setAspectRatioMode(Qt::KeepAspectRatio);
-                    ui->boardLabel->setText(PrettifyName());
-
-                    // left side
-                    PinsLeft->addWidget(padding[0],    0,  0);   // reset
-                    PinsLeft->addWidget(padding[1],    1,  0);   // 3v3_1
-                    PinsLeft->addWidget(padding[3],    2,  0);   // 3v3_2
-                    PinsLeft->addWidget(padding[4],    3,  0);   // VHi
-                    PinsLeft->addWidget(pinBoxes[26],  4,  0), PinsLeft->addWidget(pinLabel[26], 4,  1);
-                    PinsLeft->addWidget(pinBoxes[27],  5,  0), PinsLeft->addWidget(pinLabel[27], 5,  1);
-                    PinsLeft->addWidget(pinBoxes[28],  6,  0), PinsLeft->addWidget(pinLabel[28], 6,  1);
-                    PinsLeft->addWidget(pinBoxes[29],  7,  0), PinsLeft->addWidget(pinLabel[29], 7,  1);
-                    PinsLeft->addWidget(pinBoxes[24],  8,  0), PinsLeft->addWidget(pinLabel[24], 8,  1);
-                    PinsLeft->addWidget(pinBoxes[25],  9,  0), PinsLeft->addWidget(pinLabel[25], 9,  1);
-                    PinsLeft->addWidget(pinBoxes[18],  10, 0), PinsLeft->addWidget(pinLabel[18], 10, 1);
-                    PinsLeft->addWidget(pinBoxes[19],  11, 0), PinsLeft->addWidget(pinLabel[19], 11, 1);
-                    PinsLeft->addWidget(pinBoxes[20],  12, 0), PinsLeft->addWidget(pinLabel[20], 12, 1);
-                    PinsLeft->addWidget(pinBoxes[12],  13, 0), PinsLeft->addWidget(pinLabel[12], 13, 1);
-                    PinsLeft->addWidget(padding[5],    14, 0);   // bottom padding
-                    PinsLeft->addWidget(padding[6],    14, 0);
-
-                    // right side
-                    PinsRight->addWidget(padding[8],   0,  1);   // battery
-                    PinsRight->addWidget(padding[9],   1,  1);   // gnd
-                    PinsRight->addWidget(padding[10],  2,  1);   // USB power in
-                    PinsRight->addWidget(pinBoxes[11], 3,  1), PinsRight->addWidget(pinLabel[11], 3,  0);
-                    PinsRight->addWidget(pinBoxes[10], 4,  1), PinsRight->addWidget(pinLabel[10], 4,  0);
-                    PinsRight->addWidget(pinBoxes[9],  5,  1), PinsRight->addWidget(pinLabel[9],  5,  0);
-                    PinsRight->addWidget(pinBoxes[8],  6,  1), PinsRight->addWidget(pinLabel[8],  6,  0);
-                    PinsRight->addWidget(pinBoxes[7],  7,  1), PinsRight->addWidget(pinLabel[7],  7,  0);
-                    PinsRight->addWidget(pinBoxes[6],  8,  1), PinsRight->addWidget(pinLabel[6],  8,  0);
-                    PinsRight->addWidget(padding[11],  9,  1);   // 5!
-                    PinsRight->addWidget(pinBoxes[3],  10, 1), PinsRight->addWidget(pinLabel[3],  10, 0);
-                    PinsRight->addWidget(pinBoxes[2],  11, 1), PinsRight->addWidget(pinLabel[2],  11, 0);
-                    PinsRight->addWidget(pinBoxes[0],  12, 1), PinsRight->addWidget(pinLabel[0],  12, 0);
-                    PinsRight->addWidget(pinBoxes[1],  13, 1), PinsRight->addWidget(pinLabel[1],  13, 0);
-                    PinsRight->addWidget(padding[12],  14, 1);   // bottom padding
-                    PinsRight->addWidget(padding[13],  15, 1);
-
-                    // center
-                    PinsCenter->addWidget(centerPic);
-                    PinsCenter->addLayout(PinsCenterSub);
-                    centerPic->setSizePolicy(QSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding));
-                    PinsCenterSub->addWidget(pinBoxes[4], 1, 3), PinsCenterSub->addWidget(pinLabel[4], 0, 3);
-                    PinsCenterSub->addWidget(pinBoxes[5], 1, 2), PinsCenterSub->addWidget(pinLabel[5], 0, 2);
-                    break;
-                }
-                case adafruitKB2040:
-                {
-                    centerPic = new QSvgWidget(":/boardPics/adafruitKB2040.svg");
-                    QSvgRenderer *picRenderer = centerPic->renderer();
-                    picRenderer->setAspectRatioMode(Qt::KeepAspectRatio);
-                    ui->boardLabel->setText(PrettifyName());
-
-                    // left side
-                    PinsLeft->addWidget(padding[0],    0,  0);   // padding
-                    PinsLeft->addWidget(padding[1],    1,  0);   // D+
-                    PinsLeft->addWidget(pinBoxes[0],   2,  0), PinsLeft->addWidget(pinLabel[0],   2,  1);
-                    PinsLeft->addWidget(pinBoxes[1],   3,  0), PinsLeft->addWidget(pinLabel[1],   3,  1);
-                    PinsLeft->addWidget(padding[2],    4,  0);   // gnd
-                    PinsLeft->addWidget(padding[3],    5,  0);   // gnd
-                    PinsLeft->addWidget(pinBoxes[2],   6,  0), PinsLeft->addWidget(pinLabel[2],   6,  1);
-                    PinsLeft->addWidget(pinBoxes[3],   7,  0), PinsLeft->addWidget(pinLabel[3],   7,  1);
-                    PinsLeft->addWidget(pinBoxes[4],   8,  0), PinsLeft->addWidget(pinLabel[4],   8,  1);
-                    PinsLeft->addWidget(pinBoxes[5],   9,  0), PinsLeft->addWidget(pinLabel[5],   9,  1);
-                    PinsLeft->addWidget(pinBoxes[6],   10, 0), PinsLeft->addWidget(pinLabel[6],   10, 1);
-                    PinsLeft->addWidget(pinBoxes[7],   11, 0), PinsLeft->addWidget(pinLabel[7],   11, 1);
-                    PinsLeft->addWidget(pinBoxes[8],   12, 0), PinsLeft->addWidget(pinLabel[8],   12, 1);
-                    PinsLeft->addWidget(pinBoxes[9],   13, 0), PinsLeft->addWidget(pinLabel[9],   13, 1);
-
-                    // right side
-                    PinsRight->addWidget(padding[4],   0,  1);   // padding
-                    PinsRight->addWidget(padding[5],   1,  1);   // D-
-                    PinsRight->addWidget(padding[6],   2,  1);   // RAW
-                    PinsRight->addWidget(padding[7],   3,  1);   // gnd
-                    PinsRight->addWidget(padding[8],   4,  1);   // reset
-                    PinsRight->addWidget(padding[9],   5,  1);   // 3.3v
-                    PinsRight->addWidget(pinBoxes[29], 6,  1), PinsRight->addWidget(pinLabel[29], 6,  0);
-                    PinsRight->addWidget(pinBoxes[28], 7,  1), PinsRight->addWidget(pinLabel[28], 7,  0);
-                    PinsRight->addWidget(pinBoxes[27], 8,  1), PinsRight->addWidget(pinLabel[27], 8,  0);
-                    PinsRight->addWidget(pinBoxes[26], 9,  1), PinsRight->addWidget(pinLabel[26], 9,  0);
-                    PinsRight->addWidget(pinBoxes[18], 10, 1), PinsRight->addWidget(pinLabel[18], 10, 0);
-                    PinsRight->addWidget(pinBoxes[20], 11, 1), PinsRight->addWidget(pinLabel[20], 11, 0);
-                    PinsRight->addWidget(pinBoxes[19], 12, 1), PinsRight->addWidget(pinLabel[19], 12, 0);
-                    PinsRight->addWidget(pinBoxes[10], 13, 1), PinsRight->addWidget(pinLabel[10], 13, 0);
-
-                    // center
-                    PinsCenter->addWidget(centerPic);
-                    centerPic->setSizePolicy(QSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding));
-                    break;
-                }
-                case arduinoNanoRP2040:
-                {
-                    centerPic = new QSvgWidget(":/boardPics/arduinoNano2040.svg");
-                    QSvgRenderer *picRenderer = centerPic->renderer();
-                    picRenderer->setAspectRatioMode(Qt::KeepAspectRatio);
-                    PinsCenter->addWidget(centerPic);
-                    ui->boardLabel->setText(PrettifyName());
-
-                    // left side
-                    PinsLeft->addWidget(padding[0],    0,  0);   // top padding
-                    PinsLeft->addWidget(padding[1],    1,  0);
-                    PinsLeft->addWidget(padding[2],    2,  0);
-                    PinsLeft->addWidget(pinBoxes[6],   3,  0), PinsLeft->addWidget(pinLabel[6],   3,  1);
-                    PinsLeft->addWidget(padding[3],    4,  0);   // 3V3 Out
-                    PinsLeft->addWidget(padding[4],    5,  0);   // AREF
-                    PinsLeft->addWidget(pinBoxes[26],  6,  0), PinsLeft->addWidget(pinLabel[26],  6,  1);
-                    PinsLeft->addWidget(pinBoxes[27],  7,  0), PinsLeft->addWidget(pinLabel[27],  7,  1);
-                    PinsLeft->addWidget(pinBoxes[28],  8,  0), PinsLeft->addWidget(pinLabel[28],  8,  1);
-                    PinsLeft->addWidget(pinBoxes[29],  9,  0), PinsLeft->addWidget(pinLabel[29],  9,  1);
-                    PinsLeft->addWidget(pinBoxes[12],  10, 0), PinsLeft->addWidget(pinLabel[12],  10, 1);
-                    PinsLeft->addWidget(pinBoxes[13],  11, 0), PinsLeft->addWidget(pinLabel[13],  11, 1);
-                    PinsLeft->addWidget(padding[5],    12, 0);   // A6 - unused
-                    PinsLeft->addWidget(padding[6],    13, 0);   // A7 - unused
-                    PinsLeft->addWidget(padding[7],    14, 0);   // 5V OUT
-                    PinsLeft->addWidget(padding[8],    15, 0);   // REC?
-                    PinsLeft->addWidget(padding[9],    16, 0);   // gnd
-                    PinsLeft->addWidget(padding[10],   17, 0);   // 5V IN
-                    PinsLeft->addWidget(padding[11],   18, 0);   // bottom padding
-                    PinsLeft->addWidget(padding[12],   19, 0);
-
-                    // right side
-                    PinsRight->addWidget(padding[13],  0,  1);   // top padding
-                    PinsRight->addWidget(padding[14],  1,  1);   // top padding
-                    PinsRight->addWidget(padding[15],  2,  1);   // top padding
-                    PinsRight->addWidget(pinBoxes[4],  3,  1), PinsRight->addWidget(pinLabel[4],  3,  0);
-                    PinsRight->addWidget(pinBoxes[7],  4,  1), PinsRight->addWidget(pinLabel[7],  4,  0);
-                    PinsRight->addWidget(pinBoxes[5],  5,  1), PinsRight->addWidget(pinLabel[5],  5,  0);
-                    PinsRight->addWidget(pinBoxes[21], 6,  1), PinsRight->addWidget(pinLabel[21], 6,  0);
-                    PinsRight->addWidget(pinBoxes[20], 7,  1), PinsRight->addWidget(pinLabel[20], 7,  0);
-                    PinsRight->addWidget(pinBoxes[19], 8,  1), PinsRight->addWidget(pinLabel[19], 8,  0);
-                    PinsRight->addWidget(pinBoxes[18], 9,  1), PinsRight->addWidget(pinLabel[18], 9,  0);
-                    PinsRight->addWidget(pinBoxes[17], 10, 1), PinsRight->addWidget(pinLabel[17], 10, 0);
-                    PinsRight->addWidget(pinBoxes[16], 11, 1), PinsRight->addWidget(pinLabel[16], 11, 0);
-                    PinsRight->addWidget(pinBoxes[15], 12, 1), PinsRight->addWidget(pinLabel[15], 12, 0);
-                    PinsRight->addWidget(pinBoxes[25], 13, 1), PinsRight->addWidget(pinLabel[25], 13, 0);
-                    PinsRight->addWidget(padding[16],  14, 1);   // gnd
-                    PinsRight->addWidget(padding[17],  15, 1);   // RESET
-                    PinsRight->addWidget(pinBoxes[1],  16, 1), PinsRight->addWidget(pinLabel[1],  16, 0);
-                    PinsRight->addWidget(pinBoxes[0],  17, 1), PinsRight->addWidget(pinLabel[0],  17, 0);
-                    PinsRight->addWidget(padding[18],  18, 1);   // bottom padding
-                    PinsRight->addWidget(padding[19],  19, 1);
-
-                    // center
-                    PinsCenter->addWidget(centerPic);
-                    break;
-                }
-                case waveshareZero:
-                {
-                    centerPic = new QSvgWidget(":/boardPics/waveshareZero.svg");
-                    QSvgRenderer *picRenderer = centerPic->renderer();
-                    picRenderer->setAspectRatioMode(Qt::KeepAspectRatio);
-                    ui->boardLabel->setText(PrettifyName());
-
-                    // left side
-                    PinsLeft->addWidget(padding[0],   0,  0);    // 5V OUT
-                    PinsLeft->addWidget(padding[1],   1,  0);    // gnd
-                    PinsLeft->addWidget(padding[2],   2,  0);    // 3V3 OUT
-                    PinsLeft->addWidget(pinBoxes[29], 3,  0),  PinsLeft->addWidget(pinLabel[29], 3,  1);
-                    PinsLeft->addWidget(pinBoxes[28], 4,  0),  PinsLeft->addWidget(pinLabel[28], 4,  1);
-                    PinsLeft->addWidget(pinBoxes[27], 5,  0),  PinsLeft->addWidget(pinLabel[27], 5,  1);
-                    PinsLeft->addWidget(pinBoxes[26], 6,  0),  PinsLeft->addWidget(pinLabel[26], 6,  1);
-                    PinsLeft->addWidget(pinBoxes[15], 7,  0),  PinsLeft->addWidget(pinLabel[15], 7,  1);
-                    PinsLeft->addWidget(pinBoxes[14], 8,  0),  PinsLeft->addWidget(pinLabel[14], 8,  1);
-                    PinsLeft->addWidget(pinBoxes[13], 9,  0),  PinsLeft->addWidget(pinLabel[13], 9,  1);
-                    PinsLeft->addWidget(pinBoxes[12], 10, 0),  PinsLeft->addWidget(pinLabel[12], 10, 1);
-
-                    // right side
-                    PinsRight->addWidget(padding[3],  0,  1);    // padding
-                    PinsRight->addWidget(pinBoxes[0], 1,  1),  PinsRight->addWidget(pinLabel[0], 1,  0);
-                    PinsRight->addWidget(pinBoxes[1], 2,  1),  PinsRight->addWidget(pinLabel[1], 2,  0);
-                    PinsRight->addWidget(pinBoxes[2], 3,  1),  PinsRight->addWidget(pinLabel[2], 3,  0);
-                    PinsRight->addWidget(pinBoxes[3], 4,  1),  PinsRight->addWidget(pinLabel[3], 4,  0);
-                    PinsRight->addWidget(pinBoxes[4], 5,  1),  PinsRight->addWidget(pinLabel[4], 5,  0);
-                    PinsRight->addWidget(pinBoxes[5], 6,  1),  PinsRight->addWidget(pinLabel[5], 6,  0);
-                    PinsRight->addWidget(pinBoxes[6], 7,  1),  PinsRight->addWidget(pinLabel[6], 7,  0);
-                    PinsRight->addWidget(pinBoxes[7], 8,  1),  PinsRight->addWidget(pinLabel[7], 8,  0);
-                    PinsRight->addWidget(pinBoxes[8], 9,  1),  PinsRight->addWidget(pinLabel[8], 9,  0);
-                    PinsRight->addWidget(pinBoxes[9], 10, 1),  PinsRight->addWidget(pinLabel[9], 10, 0);
-
-                    // center
-                    PinsCenter->addWidget(centerPic);
-                    PinsCenter->addLayout(PinsCenterSub);
-                    centerPic->setSizePolicy(QSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding));
-                    PinsCenterSub->addWidget(pinBoxes[10], 1, 3), PinsCenterSub->addWidget(pinLabel[10], 0, 3);
-                    PinsCenterSub->addWidget(pinBoxes[11], 1, 2), PinsCenterSub->addWidget(pinLabel[11], 0, 2);
-                    break;
-                }
-                case generic:
-                {
-                    centerPic = new QSvgWidget(":/boardPics/unknown.svg");
-                    QSvgRenderer *picRenderer = centerPic->renderer();
-                    picRenderer->setAspectRatioMode(Qt::KeepAspectRatio);
-                    ui->boardLabel->setText(PrettifyName());
-
-                    // left side
-                    PinsLeft->addWidget(padding[0],    0,  0);   // padding
-                    PinsLeft->addWidget(pinBoxes[0],   1,  0), PinsLeft->addWidget(pinLabel[0],  1,  1);
-                    PinsLeft->addWidget(pinBoxes[1],   2,  0), PinsLeft->addWidget(pinLabel[1],  2,  1);
-                    PinsLeft->addWidget(padding[1],    3,  0);   // gnd
-                    PinsLeft->addWidget(pinBoxes[2],   4,  0), PinsLeft->addWidget(pinLabel[2],  4,  1);
-                    PinsLeft->addWidget(pinBoxes[3],   5,  0), PinsLeft->addWidget(pinLabel[3],  5,  1);
-                    PinsLeft->addWidget(pinBoxes[4],   6,  0), PinsLeft->addWidget(pinLabel[4],  6,  1);
-                    PinsLeft->addWidget(pinBoxes[5],   7,  0), PinsLeft->addWidget(pinLabel[5],  7,  1);
-                    PinsLeft->addWidget(padding[2],    8,  0);   // gnd
-                    PinsLeft->addWidget(pinBoxes[6],   9,  0), PinsLeft->addWidget(pinLabel[6],  9,  1);
-                    PinsLeft->addWidget(pinBoxes[7],   10, 0), PinsLeft->addWidget(pinLabel[7],  10, 1);
-                    PinsLeft->addWidget(pinBoxes[8],   11, 0), PinsLeft->addWidget(pinLabel[8],  11, 1);
-                    PinsLeft->addWidget(pinBoxes[9],   12, 0), PinsLeft->addWidget(pinLabel[9],  12, 1);
-                    PinsLeft->addWidget(padding[3],    13, 0);   // gnd
-                    PinsLeft->addWidget(pinBoxes[10],  14, 0), PinsLeft->addWidget(pinLabel[10], 14, 1);
-                    PinsLeft->addWidget(pinBoxes[11],  15, 0), PinsLeft->addWidget(pinLabel[11], 15, 1);
-                    PinsLeft->addWidget(pinBoxes[12],  16, 0), PinsLeft->addWidget(pinLabel[12], 16, 1);
-                    PinsLeft->addWidget(pinBoxes[13],  17, 0), PinsLeft->addWidget(pinLabel[13], 17, 1);
-                    PinsLeft->addWidget(padding[4],    18, 0);   // gnd
-                    PinsLeft->addWidget(pinBoxes[14],  19, 0), PinsLeft->addWidget(pinLabel[14], 19, 1);
-                    PinsLeft->addWidget(pinBoxes[15],  20, 0), PinsLeft->addWidget(pinLabel[15], 20, 1);
-
-                    // right side
-                    PinsRight->addWidget(padding[5],   0,  1);   // padding
-                    PinsRight->addWidget(padding[6],   1,  1);
-                    PinsRight->addWidget(padding[7],   2,  1);
-                    PinsRight->addWidget(padding[8],   3,  1);   // gnd
-                    PinsRight->addWidget(padding[9],   4,  1);
-                    PinsRight->addWidget(padding[10],  5,  1);
-                    PinsRight->addWidget(padding[11],  6,  1);
-                    PinsRight->addWidget(pinBoxes[28], 7,  1), PinsRight->addWidget(pinLabel[28], 7,  0);
-                    PinsRight->addWidget(padding[12],  8,  1);   // gnd
-                    PinsRight->addWidget(pinBoxes[27], 9,  1), PinsRight->addWidget(pinLabel[27], 9,  0);
-                    PinsRight->addWidget(pinBoxes[26], 10, 1), PinsRight->addWidget(pinLabel[26], 10, 0);
-                    PinsRight->addWidget(padding[13],  11, 1);
-                    PinsRight->addWidget(pinBoxes[22], 12, 1), PinsRight->addWidget(pinLabel[22], 12, 0);
-                    PinsRight->addWidget(padding[14],  13, 1);   // gnd
-                    PinsRight->addWidget(pinBoxes[21], 14, 1), PinsRight->addWidget(pinLabel[21], 14, 0);
-                    PinsRight->addWidget(pinBoxes[20], 15, 1), PinsRight->addWidget(pinLabel[20], 15, 0);
-                    PinsRight->addWidget(pinBoxes[19], 16, 1), PinsRight->addWidget(pinLabel[19], 16, 0);
-                    PinsRight->addWidget(pinBoxes[18], 17, 1), PinsRight->addWidget(pinLabel[18], 17, 0);
-                    PinsRight->addWidget(padding[17],  18, 1);   // gnd
-                    PinsRight->addWidget(pinBoxes[17], 19, 1), PinsRight->addWidget(pinLabel[17], 19, 0);
-                    PinsRight->addWidget(pinBoxes[16], 20, 1), PinsRight->addWidget(pinLabel[16], 20, 0);
-
-                    // center
-                    PinsCenter->addWidget(centerPic);
-                    centerPic->setSizePolicy(QSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding));
-                    break;
-                }
-            }
-
-            ui->tabWidget->setEnabled(true);
-            ui->customPinsEnabled->setChecked(boolSettings[customPins]);
-
-            ui->rumbleToggle->setChecked(boolSettings[rumble]);
-            ui->solenoidToggle->setChecked(boolSettings[solenoid]);
-            ui->autofireToggle->setChecked(boolSettings[autofire]);
-            ui->simplePauseToggle->setChecked(boolSettings[simplePause]);
-            ui->holdToPauseToggle->setChecked(boolSettings[holdToPause]);
-            ui->commonAnodeToggle->setChecked(boolSettings[commonAnode]);
-            ui->lowButtonsToggle->setChecked(boolSettings[lowButtonsMode]);
-            ui->rumbleFFToggle->setChecked(boolSettings[rumbleFF]);
-            ui->rumbleIntensityBox->setValue(settingsTable[rumbleStrength]);
-            ui->rumbleLengthBox->setValue(settingsTable[rumbleInterval]);
-            ui->holdToPauseLengthBox->setValue(settingsTable[holdToPauseLength]);
-            ui->solenoidNormalIntervalBox->setValue(settingsTable[solenoidNormalInterval]);
-            ui->solenoidFastIntervalBox->setValue(settingsTable[solenoidFastInterval]);
-            ui->solenoidHoldLengthBox->setValue(settingsTable[solenoidHoldLength]);
-            ui->autofireWaitFactorBox->setValue(settingsTable[autofireWaitFactor]);
-            ui->productIdInput->setText(tinyUSBtable.tinyUSBid);
-            ui->productNameInput->setText(tinyUSBtable.tinyUSBname);
-            if(inputsMap[neoPixel-1] >= 0) { ui->neopixelGroupBox->setEnabled(true); } else { ui->neopixelGroupBox->setEnabled(false); }
-            ui->neopixelStrandLengthBox->setValue(settingsTable[customLEDcount]);
-            ui->customLEDstaticSpinbox->setValue(settingsTable[customLEDstatic]);
-            ui->customLEDstaticBtn1->setStyleSheet(QString("background-color: #%1").arg(settingsTable[customLEDcolor1], 6, 16, QLatin1Char('0')));
-            ui->customLEDstaticBtn2->setStyleSheet(QString("background-color: #%1").arg(settingsTable[customLEDcolor2], 6, 16, QLatin1Char('0')));
-            ui->customLEDstaticBtn3->setStyleSheet(QString("background-color: #%1").arg(settingsTable[customLEDcolor3], 6, 16, QLatin1Char('0')));
-
-            switch(tinyUSBtable.tinyUSBid.toInt()) {
-            case 1:
-                ui->tUSB_p1->setChecked(true);
-                ui->tUSBLayoutAdvanced->setVisible(false);
-                ui->tUSBLayoutSimple->setVisible(true);
-                ui->tinyUSBLayoutToggle->setChecked(false);
-                break;
-            case 2:
-                ui->tUSB_p2->setChecked(true);
-                ui->tUSBLayoutAdvanced->setVisible(false);
-                ui->tUSBLayoutSimple->setVisible(true);
-                ui->tinyUSBLayoutToggle->setChecked(false);
-                break;
-            case 3:
-                ui->tUSB_p3->setChecked(true);
-                ui->tUSBLayoutAdvanced->setVisible(false);
-                ui->tUSBLayoutSimple->setVisible(true);
-                ui->tinyUSBLayoutToggle->setChecked(false);
-                break;
-            case 4:
-                ui->tUSB_p4->setChecked(true);
-                ui->tUSBLayoutAdvanced->setVisible(false);
-                ui->tUSBLayoutSimple->setVisible(true);
-                ui->tinyUSBLayoutToggle->setChecked(false);
-                break;
-            default:
-                ui->tUSB_p1->setChecked(false);
-                ui->tUSB_p2->setChecked(false);
-                ui->tUSB_p3->setChecked(false);
-                ui->tUSB_p4->setChecked(false);
-                ui->tUSBLayoutSimple->setVisible(false);
-                ui->tUSBLayoutAdvanced->setVisible(true);
-                ui->tinyUSBLayoutToggle->setChecked(true);
-                break;
-            }
         }
     } else {
         ui->boardLabel->clear();
+        PinsClear();
         ui->versionLabel->clear();
 
         if(serialPort.isOpen()) {
@@ -1364,6 +1064,7 @@ void guiWindow::on_comPortSelector_currentIndexChanged(int index)
             serialPort.waitForReadyRead(2000);
             serialPort.readAll();
             serialPort.close();
+            ServiceHandBack();
             if(testMode) {
                 testMode = false;
                 ui->testView->setEnabled(false);
@@ -1381,58 +1082,468 @@ void guiWindow::on_comPortSelector_currentIndexChanged(int index)
         qDebug() << "COM port disabled!";
         aliveTimer->stop();
         ui->tabWidget->setEnabled(false);
+        history.Clear();
+        HistoryActionsUpdate();
+        ui->actionStoredConfigs->setEnabled(false);
+        ui->actionImportConfig->setEnabled(false);
+        ui->actionExportConfig->setEnabled(false);
+    }
+}
+
+// Puts the freshly loaded config into the working tables (and their originals), then up on every widget in one go.
+void guiWindow::ConfigApply()
+{
+    const gunConfig_s &config = *loadedConfig;
+    board = config.board;
+    // nothing the last gun had held down carries over, and neither does its history;
+    // the diff at the end of the batch below records the starting point.
+    testState = testState_s();
+    history.Clear();
+    tinyUSBtable = config.tinyUSB;
+    tinyUSBtable_orig = config.tinyUSB;
+    for(uint8_t i = 0; i < boolTypesCount; i++) {
+        boolSettings[i] = config.boolSettings[i];
+        boolSettings_orig[i] = boolSettings[i];
+    }
+    if(boolSettings[customPins]) {
+        inputsMap_orig = config.inputsMap;
+        inputsMap = inputsMap_orig;
+    } else {
+        // the last gun's map mustn't stick around as this one's original.
+        inputsMap_orig.fill(-1);
+        inputsMap.fill(-1);
+    }
+    for(uint8_t i = 0; i < settingsTypesCount; i++) {
+        // keep what the gun actually has as the original, so an out of range value shows up as a change to save.
+        settingsTable_orig[i] = config.settingsTable[i];
+        settingsTable[i] = SettingClamp(i, settingsTable_orig[i]);
+    }
+    profilesTable = config.profiles;
+    profilesTable_orig = config.profiles;
+    ProfilesRefresh();
+
+    // new board, so everything below gets filled in as one batch, and diffed from a clean slate at the end.
+    bulkApply batch(this);
+    ui->versionLabel->setText(QString("v%1 - \"%2\"").arg(board.versionNumber).arg(board.versionCodename));
+    BoxesFill();
+    LabelsUpdate();
+
+    ui->boardLabel->setText(PrettifyName());
+    PinsLayout();
+
+    ui->tabWidget->setEnabled(true);
+    // only as many calibrate buttons as there are profiles (up to the four there's room for).
+    ui->calib1Btn->setVisible(board.profilesCount > 0);
+    ui->calib2Btn->setVisible(board.profilesCount > 1);
+    ui->calib3Btn->setVisible(board.profilesCount > 2);
+    ui->calib4Btn->setVisible(board.profilesCount > 3);
+    TogglesShow();
+    SettingsShow();
+    TinyUSBShow();
+    if(inputsMap[neoPixel-1] >= 0) { ui->neopixelGroupBox->setEnabled(true); } else { ui->neopixelGroupBox->setEnabled(false); }
+
+    ConfigStore(config, storeLoaded);
+    ui->actionStoredConfigs->setEnabled(true);
+    ui->actionImportConfig->setEnabled(true);
+    ui->actionExportConfig->setEnabled(true);
+
+    // from --apply, while there wasn't a gun to apply it to.
+    if(!pendingApply.isEmpty()) {
+        ConfigFileApply(pendingApply);
+        pendingApply.clear();
+    }
+}
+
+
+// Snapshot of the working config (edits and all), in the same form as a load.
+gunConfigRef guiWindow::WorkingConfig()
+{
+    gunConfig_s *config = new gunConfig_s;
+    config->board = board;
+    config->boardName = loadedConfig ? loadedConfig->boardName : QString();
+    config->tinyUSB = tinyUSBtable;
+    std::copy(boolSettings, boolSettings + boolTypesCount, config->boolSettings);
+    config->inputsMap = inputsMap;
+    std::copy(settingsTable, settingsTable + settingsTypesCount, config->settingsTable);
+    config->profiles = profilesTable;
+    return gunConfigRef(config);
+}
+
+
+// Puts a config from elsewhere (the store, a file) up as the working config in one batch, to be saved like any other edit.
+// The gun's own originals are left alone, so the diff shows exactly what it'd change.
+void guiWindow::ConfigWorkingApply(const gunConfig_s &config)
+{
+    bulkApply batch(this);
+    // same as what productIdInput takes: a decimal USB product ID.
+    bool idOk = false;
+    uint idValue = config.tinyUSB.tinyUSBid.toUInt(&idOk, 10);
+    if(config.tinyUSB.tinyUSBid.isEmpty() || (idOk && idValue <= 0xFFFF)) {
+        tinyUSBtable.tinyUSBid = config.tinyUSB.tinyUSBid;
+    } else {
+        Notify("TinyUSB ID not applied", QString("\"%1\" isn't a valid USB product ID, so the current one was kept.").arg(config.tinyUSB.tinyUSBid), notifyWarning);
+    }
+    tinyUSBtable.tinyUSBname = config.tinyUSB.tinyUSBname.left(TINYUSB_NAME_MAX);
+    if(config.tinyUSB.tinyUSBname.length() > TINYUSB_NAME_MAX) {
+        Notify("TinyUSB name shortened", QString("Product names can only be %1 characters long, so it was cut to \"%2\".").arg(TINYUSB_NAME_MAX).arg(tinyUSBtable.tinyUSBname), notifyInfo);
+    }
+    for(uint8_t i = 0; i < boolTypesCount; i++) {
+        // a pin map from another board means nothing on this one.
+        if(i == customPins && config.board.type != board.type) {
+            continue;
+        }
+        boolSettings[i] = config.boolSettings[i];
+    }
+    if(config.board.type == board.type) {
+        // files can be hand-edited (or damaged), so only pins this board can actually take that function go in.
+        const boardDesc_s &desc = BoardDesc(board.type);
+        uint32_t taken = 0;
+        uint8_t dropped = 0;
+        inputsMap.fill(-1);
+        for(uint8_t i = 0; i < boardInputsCount-1; i++) {
+            int8_t pin = config.inputsMap[i];
+            if(pin < 0) {
+                continue;
+            }
+            if(pin >= 30 || !(desc.usablePins & (1UL << pin)) || (taken & (1UL << pin)) ||
+               !(PinFunctionsMask(pin, desc.analogPins & (1UL << pin)) & (1ULL << (i+1)))) {
+                dropped++;
+                continue;
+            }
+            inputsMap[i] = pin;
+            taken |= 1UL << pin;
+        }
+        if(dropped) {
+            Notify("Some pins not applied", QString("%1 pin mapping(s) in this config can't be used on this board (out of range, reserved, or doubled up), so they were left unmapped.").arg(dropped), notifyWarning);
+        }
+    } else {
+        Notify("Pins not applied", QString("This config is from a different board (%1), so its pin mappings were left as they are.").arg(config.boardName), notifyInfo);
+    }
+    for(uint8_t i = 0; i < settingsTypesCount; i++) {
+        settingsTable[i] = SettingClamp(i, config.settingsTable[i]);
+    }
+    // the gun's profile count is fixed by its firmware, so only as many as both have.
+    // Calibration (offsets & LED positions) can't be sent, only redone on the gun, so that stays as the gun has it.
+    for(int i = 0; i < profilesTable.length() && i < config.profiles.length(); i++) {
+        const profilesTable_s &profile = config.profiles[i];
+        // choices the firmware doesn't know about stay as they were.
+        if(profile.irSensitivity < profilesModel::FieldOptions(profIrSensitivity).length()) {
+            profilesTable[i].irSensitivity = profile.irSensitivity;
+        }
+        if(profile.runMode < profilesModel::FieldOptions(profRunMode).length()) {
+            profilesTable[i].runMode = profile.runMode;
+        }
+        profilesTable[i].layoutType = profile.layoutType;
+        profilesTable[i].color = profile.color & 0xFFFFFF;
+        if(!profile.profName.isEmpty()) {
+            profilesTable[i].profName = profile.profName.left(PROFILE_NAME_MAX);
+        }
+    }
+
+    TogglesShow();
+    SettingsShow();
+    TinyUSBShow();
+    PinsShow();
+    ProfilesRefresh();
+    ui->boardLabel->setText(PrettifyName());
+}
+
+
+void guiWindow::ConfigStore(const gunConfig_s &config, uint8_t reason)
+{
+    if(!configStore::Record(config, gunSerial, reason)) {
+        statusBar()->showMessage("Couldn't record this config in the local store.", 5000);
+    }
+}
+
+
+void guiWindow::TogglesShow()
+{
+    ui->customPinsEnabled->setChecked(boolSettings[customPins]);
+    ui->rumbleToggle->setChecked(boolSettings[rumble]);
+    ui->solenoidToggle->setChecked(boolSettings[solenoid]);
+    ui->autofireToggle->setChecked(boolSettings[autofire]);
+    ui->simplePauseToggle->setChecked(boolSettings[simplePause]);
+    ui->holdToPauseToggle->setChecked(boolSettings[holdToPause]);
+    ui->commonAnodeToggle->setChecked(boolSettings[commonAnode]);
+    ui->lowButtonsToggle->setChecked(boolSettings[lowButtonsMode]);
+    ui->rumbleFFToggle->setChecked(boolSettings[rumbleFF]);
+}
+
+
+void guiWindow::TinyUSBShow()
+{
+    ui->productIdInput->setText(tinyUSBtable.tinyUSBid);
+    ui->productNameInput->setText(tinyUSBtable.tinyUSBname);
+    switch(tinyUSBtable.tinyUSBid.toInt()) {
+    case 1:
+        ui->tUSB_p1->setChecked(true);
+        ui->tUSBLayoutAdvanced->setVisible(false);
+        ui->tUSBLayoutSimple->setVisible(true);
+        ui->tinyUSBLayoutToggle->setChecked(false);
+        break;
+    case 2:
+        ui->tUSB_p2->setChecked(true);
+        ui->tUSBLayoutAdvanced->setVisible(false);
+        ui->tUSBLayoutSimple->setVisible(true);
+        ui->tinyUSBLayoutToggle->setChecked(false);
+        break;
+    case 3:
+        ui->tUSB_p3->setChecked(true);
+        ui->tUSBLayoutAdvanced->setVisible(false);
+        ui->tUSBLayoutSimple->setVisible(true);
+        ui->tinyUSBLayoutToggle->setChecked(false);
+        break;
+    case 4:
+        ui->tUSB_p4->setChecked(true);
+        ui->tUSBLayoutAdvanced->setVisible(false);
+        ui->tUSBLayoutSimple->setVisible(true);
+        ui->tinyUSBLayoutToggle->setChecked(false);
+        break;
+    default:
+        ui->tUSB_p1->setChecked(false);
+        ui->tUSB_p2->setChecked(false);
+        ui->tUSB_p3->setChecked(false);
+        ui->tUSB_p4->setChecked(false);
+        ui->tUSBLayoutSimple->setVisible(false);
+        ui->tUSBLayoutAdvanced->setVisible(true);
+        ui->tinyUSBLayoutToggle->setChecked(true);
+        break;
     }
 }
 
+
 void guiWindow::BoxesFill()
 {
-    // update box types
+    // swapping a box's model resets it, so only do that for pins whose capabilities changed.
+    uint32_t analogPins = BoardDesc(board.type).analogPins;
     for(uint8_t i = 0; i < 30; i++) {
-        pinBoxes[i]->addItems(valuesNameList);
-        // clear out analog options for digital pins (< GPIO26)
-        if(i < 26) {
-            pinBoxes[i]->removeItem(tempPin);
-            pinBoxes[i]->removeItem(analogY);
-            pinBoxes[i]->removeItem(analogX);
-        }
-        // filter out SCL/SDA if possible.
-        if(i & 1) {
-            pinBoxes[i]->removeItem(camSDA);
-            pinBoxes[i]->insertSeparator(camSDA);
-            pinBoxes[i]->removeItem(periphSDA);
-            pinBoxes[i]->insertSeparator(periphSDA);
-        } else {
-            pinBoxes[i]->removeItem(camSCL);
-            pinBoxes[i]->insertSeparator(camSCL);
-            pinBoxes[i]->removeItem(periphSCL);
-            pinBoxes[i]->insertSeparator(periphSCL);
+        pinFunctionsProxy *functions = PinFunctions(PinFunctionsMask(i, analogPins & (1UL << i)));
+        if(pinBoxes[i]->model() != functions) {
+            pinBoxes[i]->setModel(functions);
         }
     }
     ui->presetsBox->clear();
-    if(boardCustomPresetsCount[board.type]) {
+    const boardDesc_s &boardDesc = BoardDesc(board.type);
+    if(boardDesc.presetsCount) {
         ui->presetsBox->setHidden(false);
-        switch(board.type) {
-        case rpipico:
-        case rpipicow:
-            ui->presetsBox->setEnabled(true);
-            ui->presetsBox->addItems(rpipicoPresetsList);
-            break;
-        case adafruitItsyRP2040:
-            ui->presetsBox->setEnabled(true);
-            ui->presetsBox->addItems(adafruitItsyBitsyRP2040PresetsList);
-            break;
-        default:
-            ui->presetsBox->setEnabled(false);
+        ui->presetsBox->setEnabled(true);
+        for(uint8_t i = 0; i < boardDesc.presetsCount; i++) {
+            ui->presetsBox->addItem(boardDesc.presetsNames[i]);
         }
+        // nothing's been applied yet, so picking any of them (the first included) has to count as a change.
+        ui->presetsBox->setCurrentIndex(-1);
     } else {
         ui->presetsBox->setHidden(true);
     }
     BoxesUpdate();
 }
 
+// The filtered view of pinFunctions for a capability mask, made the first time it's asked for.
+// Boards only ever need a few distinct ones (analog or not, even or odd), so the boxes share them.
+pinFunctionsProxy *guiWindow::PinFunctions(uint64_t mask)
+{
+    pinFunctionsProxy *proxy = pinFunctionsProxies.value(mask);
+    if(!proxy) {
+        proxy = new pinFunctionsProxy(mask, pinFunctions, this);
+        pinFunctionsProxies.insert(mask, proxy);
+    }
+    return proxy;
+}
+
+// Takes every pin widget out of the pins view, without deleting any of them.
+void guiWindow::PinsClear()
+{
+    for(QGridLayout *grid : {PinsLeft, PinsRight, PinsCenterSub}) {
+        while(QLayoutItem *item = grid->takeAt(0)) {
+            if(item->widget()) {
+                item->widget()->hide();
+            }
+            delete item;
+        }
+    }
+    centerPic->hide();
+    placedBoard = nullptr;
+}
+
+
+// Places the pin boxes & labels around the board picture, going by the board's pinout.
+// Widgets come from the pool, so this is just a matter of moving them about,
+// and nothing at all if it's the same board as before.
+void guiWindow::PinsLayout()
+{
+    const boardDesc_s &boardDesc = BoardDesc(board.type);
+    if(placedBoard == &boardDesc) {
+        return;
+    }
+    const boardDesc_s *previous = placedBoard;
+    bool newPinout = !previous || qstrcmp(previous->pinout, boardDesc.pinout) != 0;
+    if(newPinout) {
+        PinsClear();
+    }
+
+    centerPic->SetPicture(boardDesc.picture);
+    centerPic->show();
+
+    if(newPinout) {
+        uint8_t pad = 0;
+        for(const pinoutSlot_s &slot : pinout::Load(boardDesc.pinout)) {
+            QWidget *box = nullptr, *label = nullptr;
+            if(slot.gpio >= 0) {
+                box = pinBoxes[slot.gpio], label = pinLabel[slot.gpio];
+            } else if(pad < 30) {
+                box = padding[pad++];
+            } else {
+                continue;
+            }
+            switch(slot.side) {
+            case pinoutLeft:
+                PinsLeft->addWidget(box, slot.position, 0);
+                if(label) { PinsLeft->addWidget(label, slot.position, 1); }
+                break;
+            case pinoutRight:
+                PinsRight->addWidget(box, slot.position, 1);
+                if(label) { PinsRight->addWidget(label, slot.position, 0); }
+                break;
+            case pinoutCenter:
+                PinsCenterSub->addWidget(box, 1, slot.position);
+                if(label) { PinsCenterSub->addWidget(label, 0, slot.position); }
+                break;
+            }
+            box->show();
+            if(label) { label->show(); }
+        }
+    }
+    placedBoard = &boardDesc;
+}
+
+
+// The profiles tab is only built the first time it's shown,
+// since most launches never get that far.
+void guiWindow::ProfilesBuild()
+{
+    if(profilesTableModel) {
+        return;
+    }
+
+    profilesTableModel = new profilesModel(profilesTable, this);
+    connect(profilesTableModel, &profilesModel::fieldEdited, this, &guiWindow::profilesTableModel_fieldEdited);
+    connect(profilesTableModel, &profilesModel::profileSelected, this, &guiWindow::profilesTableModel_profileSelected);
+    ui->profilesView->setModel(profilesTableModel);
+    ui->profilesView->setItemDelegate(new profilesDelegate(ui->profilesView));
+    ui->profilesView->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    ProfilesRefresh();
+}
+
+
+// For when profilesTable got rewritten wholesale; single edits go through the setters.
+void guiWindow::ProfilesRefresh()
+{
+    if(profilesTableModel) {
+        profilesTableModel->Reload(board.selectedProfile);
+    }
+}
+
+
+// Same deal for the test screen's button labels and IR view.
+void guiWindow::TestsBuild()
+{
+    if(testScene) {
+        return;
+    }
+
+    // Setup test screen buttons
+    for(uint8_t i = 0; i < 16; i++) {
+        testLabel[i] = new QLabel;
+        if(i == 14) {
+            testLabel[i]->setText(valuesNameList[tempPin]);
+        } else if(i == 15) {
+            testLabel[i]->setText("Analog Stick");
+        } else {
+            testLabel[i]->setText(valuesNameList[i+1]);
+        }
+        testLabel[i]->setTextFormat(Qt::PlainText);
+        testLabel[i]->setEnabled(false);
+        testLabel[i]->setAlignment(Qt::AlignCenter);
+        testLabel[i]->setFrameStyle(QFrame::Box | QFrame::Raised);
+        if(i == 15) {
+            ui->buttonsTestLayout->addWidget(testLabel[i], 3, 3, 1, 1);
+        } else if(i == 14) {
+            ui->buttonsTestLayout->addWidget(testLabel[i], 3, 1, 1, 1);
+        } else if(i > 9) {
+            ui->buttonsTestLayout->addWidget(testLabel[i], 2, i-10, 1, 1);
+        } else if(i > 4) {
+            ui->buttonsTestLayout->addWidget(testLabel[i], 1, i-5, 1, 1);
+        } else {
+            ui->buttonsTestLayout->addWidget(testLabel[i], 0, i, 1, 1);
+        }
+    }
+    testPalettes[testNormal] = testLabel[0]->palette();
+    const QColor styleColors[testStylesCount] = { QColor(), QColor(0xFF0000), QColor(0x11D00A), QColor(0xEABD2B), QColor(0xFF0000) };
+    for(uint8_t i = testPressed; i < testStylesCount; i++) {
+        testPalettes[i] = testPalettes[testNormal];
+        testPalettes[i].setColor(QPalette::Active, QPalette::WindowText, styleColors[i]);
+        testPalettes[i].setColor(QPalette::Inactive, QPalette::WindowText, styleColors[i]);
+    }
+    ui->buttonsTestLayout->setRowMinimumHeight(0, 32);
+    ui->buttonsTestLayout->setRowMinimumHeight(1, 32);
+    ui->buttonsTestLayout->setRowMinimumHeight(2, 32);
+    ui->buttonsTestLayout->setRowMinimumHeight(3, 32);
+
+    // Setup Test Mode screen colors
+    testPointTLPen.setColor(Qt::green);
+    testPointTRPen.setColor(Qt::green);
+    testPointBLPen.setColor(Qt::blue);
+    testPointBRPen.setColor(Qt::blue);
+    testPointMedPen.setColor(Qt::gray);
+    testPointDPen.setColor(Qt::red);
+    testPointTLPen.setWidth(3);
+    testPointTRPen.setWidth(3);
+    testPointBLPen.setWidth(3);
+    testPointBRPen.setWidth(3);
+    testPointMedPen.setWidth(3);
+    testPointDPen.setWidth(3);
+    testPointTL.setPen(testPointTLPen);
+    testPointTR.setPen(testPointTRPen);
+    testPointBL.setPen(testPointBLPen);
+    testPointBR.setPen(testPointBRPen);
+    testPointMed.setPen(testPointMedPen);
+    testPointD.setPen(testPointDPen);
+
+    // Actually setup the Test Mode scene
+    testScene = new QGraphicsScene();
+    testScene->setSceneRect(0, 0, 1024, 768);
+    testScene->setBackgroundBrush(Qt::darkGray);
+    ui->testView->setScene(testScene);
+    testScene->addItem(&testBox);
+    testScene->addItem(&testPointTL);
+    testScene->addItem(&testPointTR);
+    testScene->addItem(&testPointBL);
+    testScene->addItem(&testPointBR);
+    testScene->addItem(&testPointMed);
+    testScene->addItem(&testPointD);
+    // TODO: is there a way of dynamically scaling QGraphicsViews?
+    ui->testView->scale(0.5, 0.5);
+
+    // tabs are locked until a gun is loaded, but just in case.
+    if(board.type != nothing) {
+        LabelsUpdate();
+    }
+}
+
+
 // Only runs either on initial load or save
 void guiWindow::LabelsUpdate()
 {
+    if(inputsMap[ledR-1] >= 0) { ui->redLedTestBtn->setEnabled(true); } else { ui->redLedTestBtn->setEnabled(false); }
+    if(inputsMap[ledG-1] >= 0) { ui->greenLedTestBtn->setEnabled(true); } else { ui->greenLedTestBtn->setEnabled(false); }
+    if(inputsMap[ledB-1] >= 0) { ui->blueLedTestBtn->setEnabled(true); } else { ui->blueLedTestBtn->setEnabled(false); }
+
+    // test screen labels get caught up whenever it's first built.
+    if(!testLabel[0]) {
+        return;
+    }
+
     // because inputsMap uses pin no. starting from 0
     for(uint8_t i = 0; i < 16; i++) {
         if(i < 14) {
@@ -1460,10 +1571,54 @@ void guiWindow::LabelsUpdate()
                 testLabel[i]->setEnabled(false);
             }
         }
+        testLabel[i]->setPalette(testPalettes[testNormal]);
+    }
+    // labels are all back to their resting look, so whatever's going on gets redrawn next frame.
+    testShown = testState_s();
+    TestsChanged();
+}
+
+
+// Something's changed since the last frame; redraws are only ever done from testFrameTimer_timeout().
+void guiWindow::TestsChanged()
+{
+    if(testLabel[0] && !testFrameTimer.isActive()) {
+        testFrameTimer.start();
+    }
+}
+
+
+void guiWindow::testFrameTimer_timeout()
+{
+    if(!testLabel[0]) {
+        return;
+    }
+    for(uint8_t i = 0; i < testState.pressed.size(); i++) {
+        if(testState.pressed[i] != testShown.pressed[i]) {
+            testLabel[i]->setText(valuesNameList[i+1]);
+            testLabel[i]->setPalette(testPalettes[testState.pressed[i] ? testPressed : testNormal]);
+        }
     }
-    if(inputsMap[ledR-1] >= 0) { ui->redLedTestBtn->setEnabled(true); } else { ui->redLedTestBtn->setEnabled(false); }
-    if(inputsMap[ledG-1] >= 0) { ui->greenLedTestBtn->setEnabled(true); } else { ui->greenLedTestBtn->setEnabled(false); }
-    if(inputsMap[ledB-1] >= 0) { ui->blueLedTestBtn->setEnabled(true); } else { ui->blueLedTestBtn->setEnabled(false); }
+    if(testState.temperature >= 0 && testState.temperature != testShown.temperature) {
+        testLabel[14]->setText(QString("Temp: %1°C").arg(testState.temperature));
+        if(testState.temperature > tempShutoff) {
+            testLabel[14]->setPalette(testPalettes[testHot]);
+        } else if(testState.temperature > tempWarning) {
+            testLabel[14]->setPalette(testPalettes[testWarm]);
+        } else {
+            testLabel[14]->setPalette(testPalettes[testCool]);
+        }
+    }
+    if(testState.analogDir != testShown.analogDir) {
+        static const char *const analogNames[] = {
+            "Analog", "Analog 🡹", "Analog 🡼", "Analog 🡸", "Analog 🡿", "Analog 🡻", "Analog 🡾", "Analog 🡺", "Analog 🡽"
+        };
+        if(testState.analogDir < 9) {
+            testLabel[15]->setText(analogNames[testState.analogDir]);
+            testLabel[15]->setPalette(testPalettes[testState.analogDir ? testPressed : testNormal]);
+        }
+    }
+    testShown = testState;
 }
 
 void guiWindow::pinBoxes_activated(int index)
@@ -1483,300 +1638,221 @@ void guiWindow::pinBoxes_activated(int index)
     }
 
     if(!index) {
-        inputsMap[currentPins.value(pin) - 1] = -1;
+        if(pinsMapped.test(pin)) {
+            InputSet(currentPins[pin] - 1, -1);
+        }
         currentPins[pin] = btnUnmapped;
+        pinsMapped.reset(pin);
     } else if(pinBoxesOldIndex[pin] != index) {
         int8_t btnRequest = index - 1;
 
-        // Scorched Earth approach, clear anything that matches to unmapped.
-        inputsMap[btnRequest] = -1;
-        // only reset if current pin was already mapped.
-        if(currentPins.value(pin) > 0) {
-            inputsMap[currentPins.value(pin) - 1] = -1;
+        // Whichever pin had this function before gets unmapped; the reverse index says where.
+        int8_t oldPin = inputsMap[btnRequest];
+        if(oldPin >= 0 && oldPin != pin) {
+            currentPins[oldPin] = btnUnmapped;
+            pinsMapped.reset(oldPin);
+            pinBoxes[oldPin]->setCurrentIndex(btnUnmapped);
+            pinBoxesOldIndex[oldPin] = btnUnmapped;
         }
-        QList<uint8_t> foundList = currentPins.keys(index);
-        for(uint8_t i = 0; i < foundList.length(); i++) {
-            currentPins[foundList[i]] = btnUnmapped;
-            pinBoxes[foundList[i]]->setCurrentIndex(btnUnmapped);
-            pinBoxesOldIndex[foundList[i]] = btnUnmapped;
+        // only reset if current pin was already mapped.
+        if(pinsMapped.test(pin)) {
+            InputSet(currentPins[pin] - 1, -1);
         }
         // Then map the thing.
         currentPins[pin] = index;
-        inputsMap[btnRequest] = pin;
+        pinsMapped.set(pin);
+        InputSet(btnRequest, pin);
     }
     // because "->currentIndex" is already updated, we just update it at the end of activations
     // to check that we aren't re-selecting the index for that box.
     pinBoxesOldIndex[pin] = index;
     if(inputsMap[neoPixel-1] >= 0) { ui->neopixelGroupBox->setEnabled(true); } else { ui->neopixelGroupBox->setEnabled(false); }
-    DiffUpdate();
 }
 
-void guiWindow::irBoxes_activated(int index)
+void guiWindow::on_tabWidget_currentChanged(int index)
 {
-    // Demultiplexing to figure out which "pin" this combobox that's calling correlates to.
-    uint8_t slot;
-    QObject* obj = sender();
-    for(uint8_t i = 0;;i++) {
-        if(obj == irSens[i]) {
-            slot = i;
-            break;
-        }
-    }
-
-    if(index != irSensOldIndex[slot]) {
-        profilesTable[slot].irSensitivity = index;
+    QWidget *tab = ui->tabWidget->widget(index);
+    if(tab == ui->profilesTab) {
+        ProfilesBuild();
+    } else if(tab == ui->testsTab) {
+        TestsBuild();
     }
-    irSensOldIndex[slot] = index;
-    DiffUpdate();
 }
 
 
-void guiWindow::runModeBoxes_activated(int index)
+void guiWindow::on_customPinsEnabled_stateChanged(int arg1)
 {
-    // Demultiplexing to figure out which "pin" this combobox that's calling correlates to.
-    uint8_t slot;
-    QObject* obj = sender();
-    for(uint8_t i = 0;;i++) {
-        if(obj == runMode[i]) {
-            slot = i;
-            break;
-        }
-    }
-
-    if(index != runModeOldIndex[slot]) {
-        profilesTable[slot].runMode = index;
-    }
-    runModeOldIndex[slot] = index;
+    boolSettings[customPins] = arg1;
+    // rewrites the pin maps wholesale, so rescan the lot.
+    BoxesUpdate();
     DiffUpdate();
 }
 
 
-void guiWindow::renameBoxes_clicked()
+void guiWindow::on_presetsBox_currentIndexChanged(int index)
 {
-    // Demultiplexing to figure out which box we're using.
-    uint8_t slot;
-    QObject* obj = sender();
-    for(uint8_t i = 0;;i++) {
-        if(obj == renameBtn[i]) {
-            slot = i;
-            break;
-        }
-    }
-
-    // TODO: limit character length in the text dialog - for now, just use up to 15 characters.
-    QString newLabel = QInputDialog::getText(this, "Input Name", QString("Set name for profile %1").arg(slot+1));
-    if(!newLabel.isEmpty()) {
-        selectedProfile[slot]->setText(newLabel.left(15));
-        profilesTable[slot].profName = newLabel.left(15);
+    if(index > -1) {
+        const boardDesc_s &boardDesc = BoardDesc(board.type);
+        PinsApply(index < boardDesc.presetsCount ? boardDesc.presets[index] : nullptr);
     }
-    DiffUpdate();
 }
 
 
-void guiWindow::colorBoxes_clicked()
+void guiWindow::on_autoAssignBtn_clicked()
 {
-    // Demultiplexing to figure out which box we're using.
-    uint8_t slot;
-    QObject* obj = sender();
-    for(uint8_t i = 0;;i++) {
-        if(obj == color[i]) {
-            slot = i;
-            break;
+    const boardDesc_s &boardDesc = BoardDesc(board.type);
+    // everything the board maps by default needs a home, and whatever's been picked here stays put.
+    uint64_t required = 0;
+    for(uint8_t i = 0; i < 30; i++) {
+        if(boardDesc.layout[i].pinAssignment > btnUnmapped) {
+            required |= 1ULL << boardDesc.layout[i].pinAssignment;
         }
     }
-
-    QColor colorPick = QColorDialog::getColor(profilesTable[slot].color);
-    if(colorPick.isValid()) {
-        int *red = new int;
-        int *green = new int;
-        int *blue = new int;
-        colorPick.getRgb(red, green, blue);
-        uint32_t packedColor = 0;
-        packedColor |= *red << 16;
-        packedColor |= *green << 8;
-        packedColor |= *blue;
-        profilesTable[slot].color = packedColor;
-        color[slot]->setStyleSheet(QString("background-color: #%1").arg(packedColor, 6, 16, QLatin1Char('0')));
-        DiffUpdate();
+    std::array<int8_t, boardInputsCount-1> pinned;
+    pinned.fill(-1);
+    if(boolSettings[customPins]) {
+        pinned = inputsMap;
     }
-}
 
-
-void guiWindow::layoutBoxes_activated(int arg1)
-{
-    // Demultiplexing to figure out which box we're using.
-    uint8_t slot;
-    QObject* obj = sender();
-    for(uint8_t i = 0;;i++) {
-        if(obj == layoutMode[i]) {
-            slot = i;
-            break;
+    pinSolution_s solution = pinSolver::Solve(boardDesc, required, pinned.data());
+    if(!solution.solved) {
+        QStringList conflicts;
+        for(uint8_t i = 1; i < boardInputsCount; i++) {
+            if(solution.conflicts & (1ULL << i)) {
+                conflicts.append(valuesNameList[i]);
+            }
         }
+        Notify("Couldn't auto-assign pins.", QString("There's no pin left that can take: %1\n\nUnmap something from a pin that could, and try again.").arg(conflicts.join(", ")), notifyWarning);
+        return;
     }
-
-    profilesTable[slot].layoutType = arg1;
-    DiffUpdate();
-}
-
-
-void guiWindow::on_customPinsEnabled_stateChanged(int arg1)
-{
-    boolSettings[customPins] = arg1;
-    BoxesUpdate();
-    DiffUpdate();
+    ui->presetsBox->setCurrentIndex(-1);
+    PinsApply(solution.inputsMap.data());
+    statusBar()->showMessage("Pins auto-assigned.", 3000);
 }
 
 
-void guiWindow::on_presetsBox_currentIndexChanged(int index)
+// Swaps in a whole pin map (laid out like inputsMap) in one go, turning custom pins on if they weren't.
+// nullptr just clears every pin.
+void guiWindow::PinsApply(const int8_t *map)
 {
-    if(index > -1) {
-        if(!ui->customPinsEnabled->isChecked()) { ui->customPinsEnabled->setChecked(true); }
-        for(uint8_t i = 0; i < 30; i++) {
-            pinBoxes[i]->setCurrentIndex(btnUnmapped);
-            pinBoxesOldIndex[i] = btnUnmapped;
-            currentPins[i] = btnUnmapped;
-        }
+    bulkApply batch(this);
+    if(!ui->customPinsEnabled->isChecked()) {
+        ui->customPinsEnabled->setChecked(true);
+        boolSettings[customPins] = true;
+        BoxesUpdate();
+    }
+    for(uint8_t i = 0; i < 30; i++) {
+        pinBoxes[i]->setCurrentIndex(btnUnmapped);
+        pinBoxesOldIndex[i] = btnUnmapped;
+        currentPins[i] = btnUnmapped;
+    }
+    if(map) {
         for(uint8_t i = 0; i < boardInputsCount-1; i++) {
-            switch(board.type) {
-            case rpipico:
-            case rpipicow:
-                if(rpipicoPresets[index][i] > -1) {
-                    pinBoxes[rpipicoPresets[index][i]]->setCurrentIndex(i+1);
-                    pinBoxesOldIndex[rpipicoPresets[index][i]] = i+1;
-                    currentPins[rpipicoPresets[index][i]] = i+1;
-                }
-                inputsMap[i] = rpipicoPresets[index][i];
-                break;
-            case adafruitItsyRP2040:
-                if(adafruitItsyBitsyRP2040Presets[index][i] > -1) {
-                    pinBoxes[adafruitItsyBitsyRP2040Presets[index][i]]->setCurrentIndex(i+1);
-                    pinBoxesOldIndex[adafruitItsyBitsyRP2040Presets[index][i]] = i+1;
-                    currentPins[adafruitItsyBitsyRP2040Presets[index][i]] = i+1;
-                }
-                inputsMap[i] = adafruitItsyBitsyRP2040Presets[index][i];
-                break;
-            default:
-                // lol wut
-                break;
+            int8_t pin = map[i];
+            if(pin > -1) {
+                pinBoxes[pin]->setCurrentIndex(i+1);
+                pinBoxesOldIndex[pin] = i+1;
+                currentPins[pin] = i+1;
             }
         }
-        DiffUpdate();
     }
+    PinsReindex();
+    if(inputsMap[neoPixel-1] >= 0) { ui->neopixelGroupBox->setEnabled(true); } else { ui->neopixelGroupBox->setEnabled(false); }
 }
 
 
 void guiWindow::on_rumbleToggle_stateChanged(int arg1)
 {
-    boolSettings[rumble] = arg1;
+    BoolSet(rumble, arg1);
     if(!arg1) {
         ui->rumbleFFToggle->setChecked(false);
         ui->rumbleFFToggle->setEnabled(false);
     } else {
         ui->rumbleFFToggle->setEnabled(true);
     }
-    DiffUpdate();
 }
 
 
 void guiWindow::on_solenoidToggle_stateChanged(int arg1)
 {
-    boolSettings[solenoid] = arg1;
+    BoolSet(solenoid, arg1);
     if(arg1) { ui->rumbleFFToggle->setChecked(false); }
-    DiffUpdate();
 }
 
 
 void guiWindow::on_autofireToggle_stateChanged(int arg1)
 {
-    boolSettings[autofire] = arg1;
-    DiffUpdate();
+    BoolSet(autofire, arg1);
 }
 
 
 void guiWindow::on_simplePauseToggle_stateChanged(int arg1)
 {
-    boolSettings[simplePause] = arg1;
-    DiffUpdate();
+    BoolSet(simplePause, arg1);
 }
 
 
 void guiWindow::on_holdToPauseToggle_stateChanged(int arg1)
 {
-    boolSettings[holdToPause] = arg1;
-    DiffUpdate();
+    BoolSet(holdToPause, arg1);
 }
 
 
 void guiWindow::on_commonAnodeToggle_stateChanged(int arg1)
 {
-    boolSettings[commonAnode] = arg1;
-    DiffUpdate();
+    BoolSet(commonAnode, arg1);
 }
 
 
 void guiWindow::on_lowButtonsToggle_stateChanged(int arg1)
 {
-    boolSettings[lowButtonsMode] = arg1;
-    DiffUpdate();
+    BoolSet(lowButtonsMode, arg1);
 }
 
 
 void guiWindow::on_rumbleFFToggle_stateChanged(int arg1)
 {
-    boolSettings[rumbleFF] = arg1;
+    BoolSet(rumbleFF, arg1);
     if(arg1) { ui->solenoidToggle->setChecked(false); }
-    DiffUpdate();
-}
-
-
-void guiWindow::on_rumbleIntensityBox_valueChanged(int arg1)
-{
-    settingsTable[rumbleStrength] = arg1;
-    DiffUpdate();
-}
-
-
-void guiWindow::on_rumbleLengthBox_valueChanged(int arg1)
-{
-    settingsTable[rumbleInterval] = arg1;
-    DiffUpdate();
 }
 
 
-void guiWindow::on_holdToPauseLengthBox_valueChanged(int arg1)
+void guiWindow::settingBoxes_valueChanged(int value)
 {
-    settingsTable[holdToPauseLength] = arg1;
-    DiffUpdate();
-}
-
-
-void guiWindow::on_solenoidNormalIntervalBox_valueChanged(int arg1)
-{
-    settingsTable[solenoidNormalInterval] = arg1;
-    DiffUpdate();
+    // Demultiplexing to figure out which setting this box is bound to.
+    QString name = sender()->objectName();
+    for(uint8_t i = 0; i < settingsTypesCount; i++) {
+        if(name == settingsSchema[i].widget) {
+            SettingSet(i, value);
+            return;
+        }
+    }
 }
 
 
-void guiWindow::on_solenoidFastIntervalBox_valueChanged(int arg1)
+void guiWindow::settingButtons_clicked()
 {
-    settingsTable[solenoidFastInterval] = arg1;
-    DiffUpdate();
-}
-
+    // Demultiplexing to figure out which color this button is bound to.
+    QString name = sender()->objectName();
+    uint8_t type = settingsTypesCount;
+    for(uint8_t i = 0; i < settingsTypesCount; i++) {
+        if(name == settingsSchema[i].widget) {
+            type = i;
+            break;
+        }
+    }
+    if(type == settingsTypesCount) {
+        return;
+    }
 
-void guiWindow::on_solenoidHoldLengthBox_valueChanged(int arg1)
-{
-    settingsTable[solenoidHoldLength] = arg1;
-    DiffUpdate();
+    QColor colorPick = QColorDialog::getColor(settingsTable[type]);
+    if(colorPick.isValid()) {
+        SettingSet(type, colorPick.rgb() & 0xFFFFFF);
+        qobject_cast<QPushButton*>(sender())->setStyleSheet(QString("background-color: #%1").arg(settingsTable[type], 6, 16, QLatin1Char('0')));
+    }
 }
 
 
-void guiWindow::on_autofireWaitFactorBox_valueChanged(int arg1)
-{
-    settingsTable[autofireWaitFactor] = arg1;
-    DiffUpdate();
-}
-
 // decimal-to-hex conversion
 void guiWindow::on_productIdInput_textChanged(const QString &arg1)
 {
@@ -1797,11 +1873,9 @@ void guiWindow::on_productIdInput_textChanged(const QString &arg1)
 void guiWindow::on_tUSB_p1_toggled(bool checked)
 {
     if(checked) {
-        tinyUSBtable.tinyUSBid = "1";
-        tinyUSBtable.tinyUSBname = "FIRECon P1";
+        TinyUSBSet("1", "FIRECon P1");
         ui->productIdInput->setText(tinyUSBtable.tinyUSBid);
         ui->productNameInput->setText(tinyUSBtable.tinyUSBname);
-        DiffUpdate();
     }
 }
 
@@ -1809,11 +1883,9 @@ void guiWindow::on_tUSB_p1_toggled(bool checked)
 void guiWindow::on_tUSB_p2_toggled(bool checked)
 {
     if(checked) {
-        tinyUSBtable.tinyUSBid = "2";
-        tinyUSBtable.tinyUSBname = "FIRECon P2";
+        TinyUSBSet("2", "FIRECon P2");
         ui->productIdInput->setText(tinyUSBtable.tinyUSBid);
         ui->productNameInput->setText(tinyUSBtable.tinyUSBname);
-        DiffUpdate();
     }
 }
 
@@ -1821,11 +1893,9 @@ void guiWindow::on_tUSB_p2_toggled(bool checked)
 void guiWindow::on_tUSB_p3_toggled(bool checked)
 {
     if(checked) {
-        tinyUSBtable.tinyUSBid = "3";
-        tinyUSBtable.tinyUSBname = "FIRECon P3";
+        TinyUSBSet("3", "FIRECon P3");
         ui->productIdInput->setText(tinyUSBtable.tinyUSBid);
         ui->productNameInput->setText(tinyUSBtable.tinyUSBname);
-        DiffUpdate();
     }
 }
 
@@ -1833,18 +1903,16 @@ void guiWindow::on_tUSB_p3_toggled(bool checked)
 void guiWindow::on_tUSB_p4_toggled(bool checked)
 {
     if(checked) {
-        tinyUSBtable.tinyUSBid = "4";
-        tinyUSBtable.tinyUSBname = "FIRECon P4";
+        TinyUSBSet("4", "FIRECon P4");
         ui->productIdInput->setText(tinyUSBtable.tinyUSBid);
         ui->productNameInput->setText(tinyUSBtable.tinyUSBname);
-        DiffUpdate();
     }
 }
 
 
 void guiWindow::on_productIdInput_textEdited(const QString &arg1)
 {
-    tinyUSBtable.tinyUSBid = arg1;
+    TinyUSBSet(arg1, tinyUSBtable.tinyUSBname);
     if(ui->productNameInput->text().isEmpty()) {
         switch(tinyUSBtable.tinyUSBid.toInt()) {
         case 1:
@@ -1867,8 +1935,6 @@ void guiWindow::on_productIdInput_textEdited(const QString &arg1)
             break;
         }
     }
-
-    DiffUpdate();
 }
 
 
@@ -1877,8 +1943,7 @@ void guiWindow::on_productNameInput_textEdited(const QString &arg1)
     // TODO: there should be a way of using .toLocal8Bit() and checking if it's undefined,
     // as that indicates a character exceeds the normal char size, therefore
     // reset the lineEdit's text and don't change. But for now, weh.
-    tinyUSBtable.tinyUSBname = arg1;
-    DiffUpdate();
+    TinyUSBSet(tinyUSBtable.tinyUSBid, arg1);
 }
 
 
@@ -1894,38 +1959,28 @@ void guiWindow::on_tinyUSBLayoutToggle_stateChanged(int arg1)
 }
 
 
-void guiWindow::selectedProfile_isChecked(bool isChecked)
+void guiWindow::profilesTableModel_fieldEdited(uint8_t slot, uint8_t field, const QVariant &value)
 {
-    // apparently we get two signals at once? So just filter for the on.
-    if(isChecked && !serialActive) {
-        // Demultiplexing to figure out which "pin" this combobox that's calling correlates to.
-        uint8_t slot;
-        QObject* obj = sender();
-        for(uint8_t i = 0;;i++) {
-            if(obj == selectedProfile[i]) {
-                slot = i;
-                break;
-            }
-        }
-        if(slot != board.selectedProfile) {
-            serialPort.write(QString("XC%1").arg(slot+1).toLocal8Bit());
-            board.selectedProfile = slot;
-            DiffUpdate();
-        }
+    if(field == profName) {
+        ProfileNameSet(slot, value.toString().left(PROFILE_NAME_MAX));
+    } else {
+        ProfileSet(slot, field, value.toUInt());
     }
 }
 
 
-void guiWindow::on_neopixelStrandLengthBox_valueChanged(int arg1)
+void guiWindow::profilesTableModel_profileSelected(uint8_t slot)
 {
-    settingsTable[customLEDcount] = arg1;
-    DiffUpdate();
+    if(!serialActive && slot != board.selectedProfile) {
+        serialPort.write(QString("XC%1").arg(slot+1).toLocal8Bit());
+        SelectedProfileSet(slot);
+    }
 }
 
 
 void guiWindow::on_customLEDstaticSpinbox_valueChanged(int arg1)
 {
-    settingsTable[customLEDstatic] = arg1;
+    // the value itself goes through settingBoxes_valueChanged, this is just for the color buttons.
     if(customLEDstatic) {
         switch(arg1) {
         case 1:
@@ -1950,64 +2005,6 @@ void guiWindow::on_customLEDstaticSpinbox_valueChanged(int arg1)
             break;
         }
     }
-    DiffUpdate();
-}
-
-
-void guiWindow::on_customLEDstaticBtn1_clicked()
-{
-    QColor colorPick = QColorDialog::getColor(settingsTable[customLEDcolor1]);
-    if(colorPick.isValid()) {
-        int *red = new int;
-        int *green = new int;
-        int *blue = new int;
-        colorPick.getRgb(red, green, blue);
-        uint32_t packedColor = 0;
-        packedColor |= *red << 16;
-        packedColor |= *green << 8;
-        packedColor |= *blue;
-        settingsTable[customLEDcolor1] = packedColor;
-        ui->customLEDstaticBtn1->setStyleSheet(QString("background-color: #%1").arg(packedColor, 6, 16, QLatin1Char('0')));
-        DiffUpdate();
-    }
-}
-
-
-void guiWindow::on_customLEDstaticBtn2_clicked()
-{
-    QColor colorPick = QColorDialog::getColor(settingsTable[customLEDcolor2]);
-    if(colorPick.isValid()) {
-        int *red = new int;
-        int *green = new int;
-        int *blue = new int;
-        colorPick.getRgb(red, green, blue);
-        uint32_t packedColor = 0;
-        packedColor |= *red << 16;
-        packedColor |= *green << 8;
-        packedColor |= *blue;
-        settingsTable[customLEDcolor2] = packedColor;
-        ui->customLEDstaticBtn2->setStyleSheet(QString("background-color: #%1").arg(packedColor, 6, 16, QLatin1Char('0')));
-        DiffUpdate();
-    }
-}
-
-
-void guiWindow::on_customLEDstaticBtn3_clicked()
-{
-    QColor colorPick = QColorDialog::getColor(settingsTable[customLEDcolor3]);
-    if(colorPick.isValid()) {
-        int *red = new int;
-        int *green = new int;
-        int *blue = new int;
-        colorPick.getRgb(red, green, blue);
-        uint32_t packedColor = 0;
-        packedColor |= *red << 16;
-        packedColor |= *green << 8;
-        packedColor |= *blue;
-        settingsTable[customLEDcolor3] = packedColor;
-        ui->customLEDstaticBtn3->setStyleSheet(QString("background-color: #%1").arg(packedColor, 6, 16, QLatin1Char('0')));
-        DiffUpdate();
-    }
 }
 
 
@@ -2015,7 +2012,7 @@ void guiWindow::on_calib1Btn_clicked()
 {
     serialPort.write("XC1C");
     if(serialPort.waitForBytesWritten(1000)) {
-        PopupWindow("Calibrating Profile 1.", "Aim the gun at the cursor and pull the trigger to set center.\nAdjust the X & Y scales with Buttons A & B, and pull the trigger to confirm.\n\nOnce the scales are set, you'll be able to test the new settings. Press the trigger button once more to confirm.", "Calibration", 2);
+        Notify("Calibrating Profile 1.", "Aim the gun at the cursor and pull the trigger to set center.\nAdjust the X & Y scales with Buttons A & B, and pull the trigger to confirm.\n\nOnce the scales are set, you'll be able to test the new settings. Press the trigger button once more to confirm.", notifyInfo);
     }
 }
 
@@ -2024,7 +2021,7 @@ void guiWindow::on_calib2Btn_clicked()
 {
     serialPort.write("XC2C");
     if(serialPort.waitForBytesWritten(1000)) {
-        PopupWindow("Calibrating Profile 2.", "Aim the gun at the cursor and pull the trigger to set center.\nAdjust the X & Y scales with Buttons A & B, and pull the trigger to confirm.\n\nOnce the scales are set, you'll be able to test the new settings. Press the trigger button once more to confirm.", "Calibration", 2);
+        Notify("Calibrating Profile 2.", "Aim the gun at the cursor and pull the trigger to set center.\nAdjust the X & Y scales with Buttons A & B, and pull the trigger to confirm.\n\nOnce the scales are set, you'll be able to test the new settings. Press the trigger button once more to confirm.", notifyInfo);
     }
 }
 
@@ -2033,7 +2030,7 @@ void guiWindow::on_calib3Btn_clicked()
 {
     serialPort.write("XC3C");
     if(serialPort.waitForBytesWritten(1000)) {
-        PopupWindow("Calibrating Profile 3.", "Aim the gun at the cursor and pull the trigger to set center.\nAdjust the X & Y scales with Buttons A & B, and pull the trigger to confirm.\n\nOnce the scales are set, you'll be able to test the new settings. Press the trigger button once more to confirm.", "Calibration", 2);
+        Notify("Calibrating Profile 3.", "Aim the gun at the cursor and pull the trigger to set center.\nAdjust the X & Y scales with Buttons A & B, and pull the trigger to confirm.\n\nOnce the scales are set, you'll be able to test the new settings. Press the trigger button once more to confirm.", notifyInfo);
     }
 }
 
@@ -2042,7 +2039,7 @@ void guiWindow::on_calib4Btn_clicked()
 {
     serialPort.write("XC4C");
     if(serialPort.waitForBytesWritten(1000)) {
-        PopupWindow("Calibrating Profile 4.", "Aim the gun at the cursor and pull the trigger to set center.\nAdjust the X & Y scales with Buttons A & B, and pull the trigger to confirm.\n\nOnce the scales are set, you'll be able to test the new settings. Press the trigger button once more to confirm.", "Calibration", 2);
+        Notify("Calibrating Profile 4.", "Aim the gun at the cursor and pull the trigger to set center.\nAdjust the X & Y scales with Buttons A & B, and pull the trigger to confirm.\n\nOnce the scales are set, you'll be able to test the new settings. Press the trigger button once more to confirm.", notifyInfo);
     }
 }
 
@@ -2054,74 +2051,92 @@ void guiWindow::serialPort_readyRead()
             QString idleBuffer = serialPort.readLine();
             if(idleBuffer.contains("Pressed:")) {
                 uint8_t button = idleBuffer.trimmed().right(2).toInt();
-                testLabel[button-1]->setText(QString("<font color=#FF0000>%1</font>").arg(valuesNameList[button]));
+                int32_t eventValue = button;
+                eventsRing.Publish(eventPressed, ui->comPortSelector->currentIndex(), &eventValue, 1);
+                if(button >= 1 && button <= testState.pressed.size()) {
+                    testState.pressed.set(button-1);
+                    TestsChanged();
+                }
             } else if(idleBuffer.contains("Released:")) {
                 uint8_t button = idleBuffer.trimmed().right(2).toInt();
-                testLabel[button-1]->setText(valuesNameList[button]);
+                int32_t eventValue = button;
+                eventsRing.Publish(eventReleased, ui->comPortSelector->currentIndex(), &eventValue, 1);
+                if(button >= 1 && button <= testState.pressed.size()) {
+                    testState.pressed.reset(button-1);
+                    TestsChanged();
+                }
             } else if(idleBuffer.contains("Temperature:")) {
                 uint8_t temp = idleBuffer.trimmed().right(2).toInt();
-                if(temp > tempShutoff) {
-                    testLabel[14]->setText(QString("<font color=#FF0000>Temp: %1°C</font>").arg(temp));
-                } else if(temp > tempWarning) {
-                    testLabel[14]->setText(QString("<font color=#EABD2B>Temp: %1°C</font>").arg(temp));
-                } else {
-                    testLabel[14]->setText(QString("<font color=#11D00A>Temp: %1°C</font>").arg(temp));
-                }
+                int32_t eventValue = temp;
+                eventsRing.Publish(eventTemperature, ui->comPortSelector->currentIndex(), &eventValue, 1);
+                testState.temperature = temp;
+                TestsChanged();
             } else if(idleBuffer.contains("Analog:")) {
                 uint8_t analogDir = idleBuffer.trimmed().right(1).toInt();
-                if(analogDir) {
-                    switch(analogDir) {
-                    case 1: testLabel[15]->setText("<font color=#FF0000>Analog 🡹</font>"); break;
-                    case 2: testLabel[15]->setText("<font color=#FF0000>Analog 🡼</font>"); break;
-                    case 3: testLabel[15]->setText("<font color=#FF0000>Analog 🡸</font>"); break;
-                    case 4: testLabel[15]->setText("<font color=#FF0000>Analog 🡿</font>"); break;
-                    case 5: testLabel[15]->setText("<font color=#FF0000>Analog 🡻</font>"); break;
-                    case 6: testLabel[15]->setText("<font color=#FF0000>Analog 🡾</font>"); break;
-                    case 7: testLabel[15]->setText("<font color=#FF0000>Analog 🡺</font>"); break;
-                    case 8: testLabel[15]->setText("<font color=#FF0000>Analog 🡽</font>"); break;
-                    }
-                } else {
-                    testLabel[15]->setText("Analog");
-                }
-                // no idea here lol
+                int32_t eventValue = analogDir;
+                eventsRing.Publish(eventAnalog, ui->comPortSelector->currentIndex(), &eventValue, 1);
+                testState.analogDir = analogDir;
+                TestsChanged();
             } else if(idleBuffer.contains("Profile: ")) {
                 uint8_t selection = idleBuffer.trimmed().right(1).toInt();
                 if(selection != board.selectedProfile) {
-                    board.selectedProfile = selection;
-                    selectedProfile[selection]->setChecked(true);
+                    SelectedProfileSet(selection);
                 }
-                DiffUpdate();
             } else if(idleBuffer.contains("UpdatedProf: ")) {
-                uint8_t selection = idleBuffer.trimmed().right(1).toInt();
-                if(selection != board.selectedProfile) {
-                    selectedProfile[selection]->setChecked(true);
+                bool numbered = false;
+                int selection = idleBuffer.section("UpdatedProf: ", 1).trimmed().toInt(&numbered);
+                // profile counts come from the firmware now, so one we don't have is possible; its six values still need eating.
+                if(!numbered || selection < 0 || selection >= profilesTable.length()) {
+                    for(uint8_t i = 0; i < 6; i++) {
+                        serialPort.waitForReadyRead(2000);
+                        serialPort.readLine();
+                    }
+                    continue;
                 }
-                board.selectedProfile = selection;
+                // a fresh calibration comes in as one batch; undo leaves the offsets alone, but not the profile switch.
+                bulkApply batch(this);
+                SelectedProfileSet(selection);
                 serialPort.waitForReadyRead(2000);
-                topOffset[selection]->setText(serialPort.readLine().trimmed());
-                profilesTable[selection].topOffset = topOffset[selection]->text().toInt();
+                ProfileSet(selection, profTopOffset, serialPort.readLine().trimmed().toInt());
                 serialPort.waitForReadyRead(2000);
-                bottomOffset[selection]->setText(serialPort.readLine().trimmed());
-                profilesTable[selection].bottomOffset = bottomOffset[selection]->text().toInt();
+                ProfileSet(selection, profBottomOffset, serialPort.readLine().trimmed().toInt());
                 serialPort.waitForReadyRead(2000);
-                leftOffset[selection]->setText(serialPort.readLine().trimmed());
-                profilesTable[selection].leftOffset = leftOffset[selection]->text().toInt();
+                ProfileSet(selection, profLeftOffset, serialPort.readLine().trimmed().toInt());
                 serialPort.waitForReadyRead(2000);
-                rightOffset[selection]->setText(serialPort.readLine().trimmed());
-                profilesTable[selection].rightOffset = rightOffset[selection]->text().toInt();
+                ProfileSet(selection, profRightOffset, serialPort.readLine().trimmed().toInt());
                 serialPort.waitForReadyRead(2000);
-                TLled[selection]->setText(serialPort.readLine().trimmed());
-                profilesTable[selection].TLled = TLled[selection]->text().toFloat();
+                ProfileSet(selection, profTLled, serialPort.readLine().trimmed().toFloat());
                 serialPort.waitForReadyRead(2000);
-                TRled[selection]->setText(serialPort.readLine().trimmed());
-                profilesTable[selection].TRled = TRled[selection]->text().toFloat();
-                DiffUpdate();
+                ProfileSet(selection, profTRled, serialPort.readLine().trimmed().toFloat());
+                // what the gun has now is what it was loaded with plus the new calibration, not whatever's being edited here.
+                gunConfig_s calibrated = *loadedConfig;
+                if(selection < calibrated.profiles.length()) {
+                    profilesTable_s &profile = calibrated.profiles[selection];
+                    profile.topOffset = profilesTable[selection].topOffset;
+                    profile.bottomOffset = profilesTable[selection].bottomOffset;
+                    profile.leftOffset = profilesTable[selection].leftOffset;
+                    profile.rightOffset = profilesTable[selection].rightOffset;
+                    profile.TLled = profilesTable[selection].TLled;
+                    profile.TRled = profilesTable[selection].TRled;
+                }
+                calibrated.board.selectedProfile = selection;
+                loadedConfig = gunConfigRef(new gunConfig_s(calibrated));
+                ConfigStore(*loadedConfig, storeCalibrated);
             }
         }
     } else if(testMode) {
         QString testBuffer = serialPort.readLine();
         if(testBuffer.contains(',')) {
             QStringList coordsList = testBuffer.remove("\r\n").split(',', Qt::SkipEmptyParts);
+            if(coordsList.length() < 12) {
+                return;
+            }
+
+            int32_t eventValues[12];
+            for(uint8_t i = 0; i < 12; i++) {
+                eventValues[i] = coordsList[i].toInt();
+            }
+            eventsRing.Publish(eventIRPoints, ui->comPortSelector->currentIndex(), eventValues, 12);
 
             testPointTL.setRect(coordsList[0].toInt()-25, coordsList[1].toInt()-25, 50, 50);
             testPointTR.setRect(coordsList[2].toInt()-25, coordsList[3].toInt()-25, 50, 50);
@@ -2142,7 +2157,7 @@ void guiWindow::on_rumbleTestBtn_clicked()
 {
     serialPort.write("Xtr");
     if(!serialPort.waitForBytesWritten(1000)) {
-        PopupWindow("Lost connection!", "Somehow this happened I guess???", "Oops!", 4);
+        Notify("Lost connection!", "Somehow this happened I guess???", notifyError);
     } else {
         ui->statusBar->showMessage("Sent a rumble test pulse.", 2500);
     }
@@ -2153,7 +2168,7 @@ void guiWindow::on_solenoidTestBtn_clicked()
 {
     serialPort.write("Xts");
     if(!serialPort.waitForBytesWritten(1000)) {
-        PopupWindow("Lost connection!", "Somehow this happened I guess???", "Oops!", 4);
+        Notify("Lost connection!", "Somehow this happened I guess???", notifyError);
     } else {
         ui->statusBar->showMessage("Sent a solenoid test pulse.", 2500);
     }
@@ -2164,7 +2179,7 @@ void guiWindow::on_redLedTestBtn_clicked()
 {
     serialPort.write("XtR");
     if(!serialPort.waitForBytesWritten(1000)) {
-        PopupWindow("Lost connection!", "Somehow this happened I guess???", "Oops!", 4);
+        Notify("Lost connection!", "Somehow this happened I guess???", notifyError);
     } else {
         ui->statusBar->showMessage("Set LED to Red.", 2500);
     }
@@ -2175,7 +2190,7 @@ void guiWindow::on_greenLedTestBtn_clicked()
 {
     serialPort.write("XtG");
     if(!serialPort.waitForBytesWritten(1000)) {
-        PopupWindow("Lost connection!", "Somehow this happened I guess???", "Oops!", 4);
+        Notify("Lost connection!", "Somehow this happened I guess???", notifyError);
     } else {
         ui->statusBar->showMessage("Set LED to Green.", 2500);
     }
@@ -2186,7 +2201,7 @@ void guiWindow::on_blueLedTestBtn_clicked()
 {
     serialPort.write("XtB");
     if(!serialPort.waitForBytesWritten(1000)) {
-        PopupWindow("Lost connection!", "Somehow this happened I guess???", "Oops!", 4);
+        Notify("Lost connection!", "Somehow this happened I guess???", notifyError);
     } else {
         ui->statusBar->showMessage("Set LED to Blue.", 2500);
     }
@@ -2224,7 +2239,7 @@ void guiWindow::on_testBtn_clicked()
             ui->profilesTab->setEnabled(true);
             ui->feedbackTestsBox->setEnabled(true);
             ui->dangerZoneBox->setEnabled(true);
-            DiffUpdate();
+            DirtyRefresh();
             serialActive = false;
             aliveTimer->start(ALIVE_TIMER);
         }
@@ -2234,38 +2249,37 @@ void guiWindow::on_testBtn_clicked()
 
 void guiWindow::on_clearEepromBtn_clicked()
 {
-    QMessageBox messageBox;
-    messageBox.setText("Really delete saved data?");
-    messageBox.setInformativeText("This operation will delete all saved data, including:\n\n - Calibration Profiles\n - Toggles\n - Settings\n - Custom Identifiers\n\nAre you sure about this?");
-    messageBox.setWindowTitle("Delete Confirmation");
-    messageBox.setIcon(QMessageBox::Warning);
-    messageBox.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
-    messageBox.setDefaultButton(QMessageBox::Yes);
-    int value = messageBox.exec();
-    if(value == QMessageBox::Yes) {
-        if(serialPort.isOpen()) {
-            serialActive = true;
-            // clear the buffer if anything's been sent.
-            while(!serialPort.atEnd()) {
-                serialPort.readLine();
-            }
-            serialPort.write("Xc");
-            serialPort.waitForBytesWritten(2000);
-            if(serialPort.waitForReadyRead(5000)) {
-                QString buffer = serialPort.readLine();
-                if(buffer.trimmed() == "Cleared! Please reset the board.") {
-                    serialPort.write("XE");
-                    serialPort.waitForBytesWritten(2000);
-                    serialPort.close();
-                    serialActive = false;
-                    ui->comPortSelector->setCurrentIndex(0);
-                    PopupWindow("Cleared storage.", "Please unplug the board and reinsert it into the PC.", "Clear Finished", 1);
-                }
+    Confirm("Really delete saved data?", "This operation will delete all saved data, including:\n\n - Calibration Profiles\n - Toggles\n - Settings\n - Custom Identifiers\n\nAre you sure about this?", "Delete Confirmation", notifyWarning,
+            [this]() { StorageClear(); },
+            [this]() {
+                //qDebug() << "Clear operation canceled.";
+                ui->statusBar->showMessage("Clear operation canceled.", 3000);
+            });
+}
+
+
+void guiWindow::StorageClear()
+{
+    if(serialPort.isOpen()) {
+        serialActive = true;
+        // clear the buffer if anything's been sent.
+        while(!serialPort.atEnd()) {
+            serialPort.readLine();
+        }
+        serialPort.write("Xc");
+        serialPort.waitForBytesWritten(2000);
+        if(serialPort.waitForReadyRead(5000)) {
+            QString buffer = serialPort.readLine();
+            if(buffer.trimmed() == "Cleared! Please reset the board.") {
+                serialPort.write("XE");
+                serialPort.waitForBytesWritten(2000);
+                serialPort.close();
+                ServiceHandBack();
+                serialActive = false;
+                ui->comPortSelector->setCurrentIndex(0);
+                Notify("Cleared storage.", "Please unplug the board and reinsert it into the PC.", notifyInfo);
             }
         }
-    } else {
-        //qDebug() << "Clear operation canceled.";
-        ui->statusBar->showMessage("Clear operation canceled.", 3000);
     }
 }
 
@@ -2277,6 +2291,7 @@ void guiWindow::on_baudResetBtn_clicked()
     serialPort.write("Xxx");
     serialPort.waitForBytesWritten(1000);
     serialPort.close();
+    ServiceHandBack();
 
 /* test stuff for potential app FW update functionality
     // At least on my system, the Bootloader device takes ~7s to appear
@@ -2300,6 +2315,173 @@ void guiWindow::on_baudResetBtn_clicked()
     serialActive = false;
 }
 
+void guiWindow::on_actionUndo_triggered()
+{
+    if(history.CanUndo()) {
+        HistoryRestore(history.Undo());
+    }
+}
+
+
+void guiWindow::on_actionRedo_triggered()
+{
+    if(history.CanRedo()) {
+        HistoryRestore(history.Redo());
+    }
+}
+
+
+// Lists everything the store has seen on this gun, newest first, and puts the pick up as the working config.
+void guiWindow::on_actionStoredConfigs_triggered()
+{
+    QVector<storeEntry_s> entries = configStore::History(gunSerial);
+    if(entries.isEmpty()) {
+        statusBar()->showMessage("No configs stored for this gun yet.", 5000);
+        return;
+    }
+    std::reverse(entries.begin(), entries.end());
+    const char *reasons[] = { "loaded", "saved", "calibrated" };
+    QStringList items;
+    for(const storeEntry_s &entry : std::as_const(entries)) {
+        items.append(QString("%1 - %2 (%3)").arg(QDateTime::fromMSecsSinceEpoch(entry.timestamp).toString("yyyy-MM-dd hh:mm:ss"),
+                                                 reasons[entry.reason], QString(entry.hash.left(8))));
+    }
+    bool picked = false;
+    QString item = QInputDialog::getItem(this, "Restore Stored Config", "Config to restore (unsaved until you hit Save):", items, 0, false, &picked);
+    if(!picked) {
+        return;
+    }
+    gunConfigRef config = configStore::Load(entries[items.indexOf(item)].hash);
+    if(!config) {
+        Notify("Can't restore config", "That config is missing from the local store, or was damaged.", notifyWarning);
+        return;
+    }
+    ConfigWorkingApply(*config);
+}
+
+
+// Puts a config file up as the working config, same as restoring one from the store; e.g. to clone a tuned gun onto a new board.
+void guiWindow::on_actionImportConfig_triggered()
+{
+    QString path = QFileDialog::getOpenFileName(this, "Import Config", QString(), "OpenFIRE configs (*.ofcfg *.json);;All files (*)");
+    if(!path.isEmpty()) {
+        ConfigFileApply(path);
+    }
+}
+
+
+// Puts an exported config file up as the working config, from the Import menu or --apply.
+void guiWindow::ConfigFileApply(const QString &path)
+{
+    QString error;
+    gunConfigRef config = gunConfig::Import(path, error);
+    if(!config) {
+        Notify("Can't import config", QString("%1\n\n%2").arg(path, error), notifyWarning);
+        return;
+    }
+    ConfigWorkingApply(*config);
+    statusBar()->showMessage("Imported config; hit Save to send it to the gun.", 5000);
+}
+
+
+// Exports the working config, unsaved edits included.
+void guiWindow::on_actionExportConfig_triggered()
+{
+    QString filter;
+    QString path = QFileDialog::getSaveFileName(this, "Export Config", tinyUSBtable.tinyUSBname,
+                                                "OpenFIRE config (*.ofcfg);;JSON, for reading over (*.json)", &filter);
+    if(path.isEmpty()) {
+        return;
+    }
+    // the form's picked by extension, so make sure there is one.
+    if(QFileInfo(path).suffix().isEmpty()) {
+        path.append(filter.contains("*.json") ? ".json" : ".ofcfg");
+    }
+    QString error;
+    if(!gunConfig::Export(*WorkingConfig(), path, error)) {
+        Notify("Can't export config", QString("%1\n\n%2").arg(path, error), notifyWarning);
+        return;
+    }
+    statusBar()->showMessage("Exported config to " + path, 5000);
+}
+
+
+// The working config as it stands, for the history to hang onto.
+configState_s guiWindow::HistoryState()
+{
+    configState_s state;
+    std::array<bool, boolTypesCount> bools;
+    std::copy(boolSettings, boolSettings + boolTypesCount, bools.begin());
+    state.bools.reset(new std::array<bool, boolTypesCount>(bools));
+    state.pins.reset(new std::array<int8_t, boardInputsCount-1>(inputsMap));
+    std::array<uint32_t, settingsTypesCount> settings;
+    std::copy(settingsTable, settingsTable + settingsTypesCount, settings.begin());
+    state.settings.reset(new std::array<uint32_t, settingsTypesCount>(settings));
+    state.tinyUSB.reset(new tinyUSBtable_s(tinyUSBtable));
+    state.profiles = profilesTable;
+    state.selectedProfile = board.selectedProfile;
+    return state;
+}
+
+
+// Called after every edit; batches only get recorded as a whole, once they're done.
+void guiWindow::HistoryRecord(int field)
+{
+    if(bulkDepth || historyRestoring || board.type == nothing) {
+        return;
+    }
+    if(history.Record(HistoryState(), field)) {
+        HistoryActionsUpdate();
+    }
+}
+
+
+// Puts a state from the history back as the working config, widgets and all, without a trip to the gun.
+void guiWindow::HistoryRestore(const configState_s &state)
+{
+    historyRestoring = true;
+    {
+        bulkApply batch(this);
+        std::copy(state.bools->begin(), state.bools->end(), boolSettings);
+        inputsMap = *state.pins;
+        std::copy(state.settings->begin(), state.settings->end(), settingsTable);
+        tinyUSBtable = *state.tinyUSB;
+        // calibration's already on the gun and can't be sent back, so undo only goes over what can be saved.
+        for(int i = 0; i < profilesTable.length() && i < state.profiles.length(); i++) {
+            profilesTable_s profile = state.profiles[i];
+            profile.topOffset = profilesTable[i].topOffset;
+            profile.bottomOffset = profilesTable[i].bottomOffset;
+            profile.leftOffset = profilesTable[i].leftOffset;
+            profile.rightOffset = profilesTable[i].rightOffset;
+            profile.TLled = profilesTable[i].TLled;
+            profile.TRled = profilesTable[i].TRled;
+            profilesTable[i] = profile;
+        }
+        // the gun's active profile is switched as soon as it's picked, so switching back has to tell it too.
+        if(state.selectedProfile != board.selectedProfile && !serialActive) {
+            serialPort.write(QString("XC%1").arg(state.selectedProfile+1).toLocal8Bit());
+        }
+        board.selectedProfile = state.selectedProfile;
+
+        TogglesShow();
+        SettingsShow();
+        TinyUSBShow();
+        PinsShow();
+        ProfilesRefresh();
+        ui->boardLabel->setText(PrettifyName());
+    }
+    historyRestoring = false;
+    HistoryActionsUpdate();
+}
+
+
+void guiWindow::HistoryActionsUpdate()
+{
+    ui->actionUndo->setEnabled(history.CanUndo());
+    ui->actionRedo->setEnabled(history.CanRedo());
+}
+
+
 void guiWindow::on_actionAbout_UI_triggered()
 {
     QDialog *about = new QDialog;
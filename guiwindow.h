@@ -19,11 +19,19 @@
 #define GUIWINDOW_H
 
 #include "constants.h"
+#include "eventring.h"
+#include "configdiff.h"
+#include "gunconfig.h"
+#include "confighistory.h"
 #include <QMainWindow>
 #include <QSerialPort>
 #include <QGraphicsItem>
 #include <QPen>
+#include <QPointer>
+#include <QThread>
 #include <QTimer>
+#include <bitset>
+#include <functional>
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -31,6 +39,9 @@ class guiWindow;
 }
 QT_END_NAMESPACE
 
+class pinFunctionsProxy;
+class toastStack;
+
 class guiWindow : public QMainWindow
 {
     Q_OBJECT
@@ -43,9 +54,21 @@ public:
 
     bool serialActive = false;
 
+public slots:
+    void HandleArguments(const QStringList &args);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
 private slots:
     void aliveTimer_timeout();
 
+    void testFrameTimer_timeout();
+
+    void portsThread_finished();
+
+    void loadThread_finished();
+
     void on_comPortSelector_currentIndexChanged(int index);
 
     void on_confirmButton_clicked();
@@ -54,20 +77,14 @@ private slots:
 
     void pinBoxes_activated(int index);
 
-    void renameBoxes_clicked();
-
-    void colorBoxes_clicked();
-
-    void layoutBoxes_activated(int arg1);
-
-    void irBoxes_activated(int index);
-
-    void runModeBoxes_activated(int index);
+    void on_tabWidget_currentChanged(int index);
 
     void on_customPinsEnabled_stateChanged(int arg1);
 
     void on_presetsBox_currentIndexChanged(int index);
 
+    void on_autoAssignBtn_clicked();
+
     void on_rumbleTestBtn_clicked();
 
     void on_solenoidTestBtn_clicked();
@@ -90,33 +107,19 @@ private slots:
 
     void on_rumbleFFToggle_stateChanged(int arg1);
 
-    void on_rumbleIntensityBox_valueChanged(int arg1);
-
-    void on_rumbleLengthBox_valueChanged(int arg1);
-
-    void on_holdToPauseLengthBox_valueChanged(int arg1);
-
-    void on_solenoidNormalIntervalBox_valueChanged(int arg1);
-
-    void on_solenoidFastIntervalBox_valueChanged(int arg1);
-
-    void on_solenoidHoldLengthBox_valueChanged(int arg1);
-
-    void on_autofireWaitFactorBox_valueChanged(int arg1);
-
     void on_productIdInput_textEdited(const QString &arg1);
 
     void on_productNameInput_textEdited(const QString &arg1);
 
-    void on_neopixelStrandLengthBox_valueChanged(int arg1);
-
     void on_clearEepromBtn_clicked();
 
     void on_productIdInput_textChanged(const QString &arg1);
 
     void on_testBtn_clicked();
 
-    void selectedProfile_isChecked(bool isChecked);
+    void profilesTableModel_fieldEdited(uint8_t slot, uint8_t field, const QVariant &value);
+
+    void profilesTableModel_profileSelected(uint8_t slot);
 
     void on_calib1Btn_clicked();
 
@@ -128,13 +131,21 @@ private slots:
 
     void on_actionAbout_UI_triggered();
 
-    void on_customLEDstaticSpinbox_valueChanged(int arg1);
+    void on_actionUndo_triggered();
+
+    void on_actionRedo_triggered();
+
+    void on_actionStoredConfigs_triggered();
+
+    void on_actionImportConfig_triggered();
 
-    void on_customLEDstaticBtn1_clicked();
+    void on_actionExportConfig_triggered();
 
-    void on_customLEDstaticBtn2_clicked();
+    void settingBoxes_valueChanged(int value);
 
-    void on_customLEDstaticBtn3_clicked();
+    void settingButtons_clicked();
+
+    void on_customLEDstaticSpinbox_valueChanged(int arg1);
 
     void on_tinyUSBLayoutToggle_stateChanged(int arg1);
 
@@ -155,6 +166,28 @@ private slots:
 private:
     Ui::guiWindow *ui;
 
+    // Scope for pushing a whole batch of values into the widgets at once (loads, presets).
+    // While one's alive, the tabs' input widgets have their signals blocked so none of their
+    // handlers run per widget, and the window doesn't repaint; once the outermost one goes,
+    // BulkCommit() works out whatever those handlers would have, and it all gets drawn once.
+    class bulkApply {
+    public:
+        bulkApply(guiWindow *window);
+        ~bulkApply();
+
+    private:
+        guiWindow *window;
+        QList<QWidget*> blocked;
+    };
+
+    // how many bulkApply scopes are open
+    uint8_t bulkDepth = 0;
+
+    // Every state the working config's been in since it was loaded, for undo/redo.
+    configHistory history;
+    // set while a state's being put back, so that doesn't get recorded as an edit of its own.
+    bool historyRestoring = false;
+
     // Used by pinBoxes, matching boardInputs_e
     QStringList valuesNameList = {
         "Unmapped",
@@ -196,6 +229,29 @@ private:
     // Extracted COM paths, as provided from serialFoundList
     QStringList usbName;
 
+    // Background port enumeration, started from PortsSearch(); null once it's done.
+    QPointer<QThread> portsThread;
+    // What the above found, picked up by portsThread_finished()
+    QList<QSerialPortInfo> portsFound;
+    // Arguments that came in before the ports were known, to be run once they are.
+    QStringList pendingArgs;
+    // Config file from --apply, waiting on a gun to be loaded.
+    QString pendingApply;
+
+    // Decodes a load's replies, started from SerialLoad(); null once it's done (or superseded by another port).
+    QPointer<QThread> loadThread;
+    // What the above decoded, picked up by loadThread_finished()
+    gunConfigRef decodedConfig;
+    // The config as last loaded from the board (or saved to it, or calibrated on it). Never changes under anyone holding it,
+    // so it can be handed out as is to whatever else wants to look at it.
+    gunConfigRef loadedConfig;
+
+    // USB serial number of the open gun (or its port, if it has none), which its configs are stored under.
+    QString gunSerial;
+
+    // Port borrowed from the background service, to be handed back once we close it.
+    QString servicePort;
+
     // Tracks the amount of differences between current config and loaded config.
     // Resets after every call to DiffUpdate()
     uint8_t settingsDiff;
@@ -219,18 +275,33 @@ private:
     // and then update it at the end of the activate signal.
     int pinBoxesOldIndex[30];
 
-    // Uses the same logic as pinBoxesOldIndex, since the irSensor and runMode comboboxes
-    // are hooked to a single signal.
-    uint8_t irSensOldIndex[4];
-    uint8_t runModeOldIndex[4];
-
     bool testMode = false;
 
+    // Latest of what the gun's reported on its idle stream. readyRead only ever writes in here;
+    // testFrameTimer then puts whatever changed onto the test labels, at most once per display frame.
+    typedef struct testState_t {
+        std::bitset<14> pressed;
+        // -1 = none reported yet
+        int temperature = -1;
+        uint8_t analogDir = 0;
+    } testState_s;
+    testState_s testState;
+    // what the labels currently show
+    testState_s testShown;
+
+    QTimer testFrameTimer;
+
     // for timer
     bool boardIsAlive = false;
 
     QTimer *aliveTimer;
 
+    // non-modal notices, see Notify()
+    toastStack *toasts;
+
+    // Shared memory feed of button/temp/analog/IR events for other local programs.
+    eventRing eventsRing;
+
     // Test Mode screen points & colors
     QGraphicsEllipseItem testPointTL;
     QGraphicsEllipseItem testPointTR;
@@ -255,19 +326,98 @@ private:
 
     void BoxesUpdate();
 
+    void PinsShow();
+
+    void TogglesShow();
+
+    void TinyUSBShow();
+
+    configState_s HistoryState();
+
+    void HistoryRecord(int field);
+
+    void HistoryRestore(const configState_s &state);
+
+    void HistoryActionsUpdate();
+
+    void PinsReindex();
+
+    void PinsApply(const int8_t *map);
+
+    void PinsLayout();
+
+    void PinsClear();
+
+    pinFunctionsProxy *PinFunctions(uint64_t mask);
+
     void LabelsUpdate();
 
+    void ProfilesBuild();
+
+    void ProfilesRefresh();
+
+    void TestsBuild();
+
+    void TestsChanged();
+
     void DiffUpdate();
 
+    void BulkCommit();
+
+    void DirtyRefresh();
+
+    void DirtyMark(uint16_t field, bool dirty);
+
+    void BoolSet(uint8_t type, bool value);
+
+    void InputSet(uint8_t input, int8_t pin);
+
+    void SettingSet(uint8_t type, uint32_t value);
+
+    void SettingsBind();
+
+    void SettingsShow();
+
+    void TinyUSBSet(const QString &id, const QString &name);
+
+    void SelectedProfileSet(uint8_t slot);
+
+    void ProfileSet(uint8_t slot, uint8_t field, uint32_t value);
+
+    void ProfileNameSet(uint8_t slot, const QString &name);
+
+    packedConfig_s PackConfig(bool loaded);
+
     void PopupWindow(QString errorTitle, QString errorMessage, QString windowTitle, int errorType);
 
+    void Notify(const QString &title, const QString &message, uint8_t severity);
+
+    void Confirm(const QString &title, const QString &message, const QString &windowTitle, int errorType,
+                 std::function<void()> accepted, std::function<void()> declined);
+
+    void ConfigCommit();
+
+    void StorageClear();
+
     void PortsSearch();
 
     void SelectionUpdate(uint8_t newSelection);
 
     bool SerialInit(int portNum);
 
-    void SerialLoad();
+    void SerialLoad(const gunReplies_s &replies);
+
+    void ConfigApply();
+
+    gunConfigRef WorkingConfig();
+
+    void ConfigWorkingApply(const gunConfig_s &config);
+
+    void ConfigFileApply(const QString &path);
+
+    void ConfigStore(const gunConfig_s &config, uint8_t reason);
+
+    void ServiceHandBack();
 
     void SyncSettings();
 };
@@ -0,0 +1,439 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "gunconfig.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSerialPort>
+
+// Next line from the gun (untrimmed), or an empty array if it didn't come in time.
+static QByteArray Reply(QSerialPort &port)
+{
+    while(!port.canReadLine()) {
+        if(!port.waitForReadyRead(2000)) {
+            return QByteArray();
+        }
+    }
+    return port.readLine();
+}
+
+static QByteArray Ask(QSerialPort &port, const QByteArray &command)
+{
+    port.write(command);
+    if(!port.waitForBytesWritten(2000)) {
+        return QByteArray();
+    }
+    return Reply(port);
+}
+
+// Handshake is "OpenFIRE,<version>,<codename>,<board>,<selected profile>[,<profiles count>]"
+static bool HandshakeValid(const QList<QByteArray> &fields)
+{
+    return fields.length() >= 5 && fields[0].contains("OpenFIRE");
+}
+
+// firmware that doesn't say how many profiles it has is from when there were always 4.
+static uint8_t HandshakeProfiles(const QList<QByteArray> &fields)
+{
+    if(fields.length() > 5 && fields[5].trimmed().toInt() > 0) {
+        return qMin(fields[5].trimmed().toInt(), PROFILES_MAX);
+    }
+    return PROFILES_COUNT;
+}
+
+gunQuery_e gunConfig::Query(QSerialPort &port, gunReplies_s &replies)
+{
+    port.write("XP");
+    if(!port.waitForBytesWritten(2000)) {
+        return queryNoWrite;
+    }
+    replies.handshake = Reply(port);
+    const QList<QByteArray> handshake = replies.handshake.trimmed().split(',');
+    if(replies.handshake.isEmpty()) {
+        return queryNoReply;
+    } else if(handshake[0].contains("Device not available")) {
+        return queryNoCamera;
+    } else if(!HandshakeValid(handshake)) {
+        return queryNotOpenFIRE;
+    }
+
+    replies.tinyUSB = Ask(port, "Xli");
+    replies.bools = Ask(port, "Xlb");
+    if(replies.bools.trimmed().split(',').value(customPins).toInt()) {
+        replies.pins = Ask(port, "Xlp");
+    }
+    replies.settings = Ask(port, "Xls");
+    uint8_t profilesCount = HandshakeProfiles(handshake);
+    for(uint8_t i = 0; i < profilesCount; i++) {
+        replies.profiles.append(Ask(port, QString("XlP%1").arg(i).toLocal8Bit()));
+    }
+    return queryOk;
+}
+
+gunConfigRef gunConfig::Decode(const gunReplies_s &replies)
+{
+    gunConfig_s *config = new gunConfig_s;
+    config->inputsMap.fill(-1);
+
+    const QList<QByteArray> handshake = replies.handshake.trimmed().split(',');
+    QStringList buffer = QString(replies.handshake).trimmed().split(',');
+    if(!HandshakeValid(handshake)) {
+        config->error = buffer[0].contains("Device not available") ? "Camera not available" : "No handshake";
+        return gunConfigRef(config);
+    }
+    config->board.versionNumber = buffer[1].toFloat();
+    config->board.versionCodename = buffer[2];
+    config->boardName = buffer[3];
+    config->board.type = BoardTypeFromName(buffer[3]);
+    config->board.selectedProfile = buffer[4].toInt();
+    config->board.previousProfile = config->board.selectedProfile;
+    config->board.profilesCount = HandshakeProfiles(handshake);
+
+    buffer = QString(replies.tinyUSB).trimmed().split(',');
+    if(buffer.length() >= 2) {
+        config->tinyUSB.tinyUSBid = buffer[0];
+        config->tinyUSB.tinyUSBname = buffer[1] == "SERIALREADERR01" ? "" : buffer[1];
+    }
+
+    buffer = QString(replies.bools).trimmed().split(',');
+    if(buffer.length() >= boolTypesCount) {
+        for(uint8_t i = 0; i < boolTypesCount; i++) {
+            config->boolSettings[i] = buffer[i].toInt();
+        }
+    } else {
+        config->error = "Bad toggles reply";
+    }
+
+    if(config->boolSettings[customPins]) {
+        buffer = QString(replies.pins).trimmed().split(',');
+        if(buffer.length() >= boardInputsCount-1) {
+            for(uint8_t i = 0; i < boardInputsCount-1; i++) {
+                config->inputsMap[i] = buffer[i].toInt();
+            }
+        } else if(config->error.isEmpty()) {
+            config->error = "Bad pins reply";
+        }
+    }
+
+    const QString settings = QString(replies.settings).trimmed();
+    buffer = settings.isEmpty() ? QStringList() : settings.split(',');
+    if(buffer.isEmpty() && config->error.isEmpty()) {
+        config->error = "Bad settings reply";
+    }
+    for(uint8_t i = 0; i < settingsTypesCount; i++) {
+        // older firmware that doesn't know about this one yet gets the default.
+        config->settingsTable[i] = settingsSchema[i].id < buffer.length() ? buffer[settingsSchema[i].id].toInt() : settingsSchema[i].def;
+    }
+
+    config->profiles.resize(config->board.profilesCount);
+    for(uint8_t i = 0; i < config->board.profilesCount; i++) {
+        buffer = QString(replies.profiles.value(i)).trimmed().split(',');
+        if(buffer.length() < 11) {
+            if(config->error.isEmpty()) {
+                config->error = QString("Bad profile %1 reply").arg(i+1);
+            }
+            continue;
+        }
+        profilesTable_s &profile = config->profiles[i];
+        profile.topOffset = buffer[0].toInt();
+        profile.bottomOffset = buffer[1].toInt();
+        profile.leftOffset = buffer[2].toInt();
+        profile.rightOffset = buffer[3].toInt();
+        profile.TLled = buffer[4].toFloat();
+        profile.TRled = buffer[5].toFloat();
+        profile.irSensitivity = buffer[6].toInt();
+        profile.runMode = buffer[7].toInt();
+        profile.layoutType = buffer[8].toInt();
+        profile.color = buffer[9].toLong();
+        profile.profName = buffer[10];
+    }
+    return gunConfigRef(config);
+}
+
+void gunConfig::ToJson(const gunConfig_s &config, QJsonObject &json)
+{
+    QJsonObject firmware;
+    firmware["version"] = config.board.versionNumber;
+    firmware["codename"] = config.board.versionCodename;
+    json["firmware"] = firmware;
+    json["board"] = config.boardName;
+    json["selectedProfile"] = config.board.selectedProfile;
+
+    QJsonObject tinyUSB;
+    tinyUSB["id"] = config.tinyUSB.tinyUSBid;
+    tinyUSB["name"] = config.tinyUSB.tinyUSBname;
+    json["tinyUSB"] = tinyUSB;
+
+    QJsonObject toggles;
+    for(uint8_t i = 0; i < boolTypesCount; i++) {
+        toggles[boolTypesNames[i]] = config.boolSettings[i];
+    }
+    json["toggles"] = toggles;
+
+    if(config.boolSettings[customPins]) {
+        QJsonObject pins;
+        for(uint8_t i = 0; i < boardInputsCount-1; i++) {
+            pins[boardInputsNames[i+1]] = config.inputsMap[i];
+        }
+        json["pins"] = pins;
+    }
+
+    QJsonObject settings;
+    for(uint8_t i = 0; i < settingsTypesCount; i++) {
+        settings[settingsSchema[i].name] = qint64(config.settingsTable[i]);
+    }
+    json["settings"] = settings;
+
+    QJsonArray profiles;
+    for(const profilesTable_s &profile : config.profiles) {
+        QJsonObject prof;
+        prof["name"] = profile.profName;
+        prof["topOffset"] = profile.topOffset;
+        prof["bottomOffset"] = profile.bottomOffset;
+        prof["leftOffset"] = profile.leftOffset;
+        prof["rightOffset"] = profile.rightOffset;
+        prof["TLled"] = profile.TLled;
+        prof["TRled"] = profile.TRled;
+        prof["irSensitivity"] = profile.irSensitivity;
+        prof["runMode"] = profile.runMode;
+        prof["layoutType"] = profile.layoutType;
+        prof["color"] = qint64(profile.color);
+        profiles.append(prof);
+    }
+    json["profiles"] = profiles;
+}
+
+void gunConfig::FromJson(const QJsonObject &json, gunConfig_s &config)
+{
+    const QJsonObject firmware = json["firmware"].toObject();
+    config.board.versionNumber = firmware["version"].toDouble();
+    config.board.versionCodename = firmware["codename"].toString();
+    config.boardName = json["board"].toString();
+    config.board.type = config.boardName.isEmpty() ? uint8_t(nothing) : BoardTypeFromName(config.boardName);
+    config.board.selectedProfile = json["selectedProfile"].toInt();
+    config.board.previousProfile = config.board.selectedProfile;
+
+    const QJsonObject tinyUSB = json["tinyUSB"].toObject();
+    config.tinyUSB.tinyUSBid = tinyUSB["id"].toString();
+    config.tinyUSB.tinyUSBname = tinyUSB["name"].toString();
+
+    const QJsonObject toggles = json["toggles"].toObject();
+    for(uint8_t i = 0; i < boolTypesCount; i++) {
+        config.boolSettings[i] = toggles[boolTypesNames[i]].toBool();
+    }
+
+    const QJsonObject pins = json["pins"].toObject();
+    for(uint8_t i = 0; i < boardInputsCount-1; i++) {
+        config.inputsMap[i] = pins[boardInputsNames[i+1]].toInt(-1);
+    }
+
+    const QJsonObject settings = json["settings"].toObject();
+    for(uint8_t i = 0; i < settingsTypesCount; i++) {
+        // older files may not have every setting, so those read as the firmware default.
+        config.settingsTable[i] = settings.contains(settingsSchema[i].name) ?
+                                uint32_t(settings[settingsSchema[i].name].toVariant().toLongLong()) : settingsSchema[i].def;
+    }
+
+    config.profiles.clear();
+    for(const QJsonValue &value : json["profiles"].toArray()) {
+        const QJsonObject prof = value.toObject();
+        profilesTable_s profile;
+        profile.profName = prof["name"].toString();
+        profile.topOffset = prof["topOffset"].toInt();
+        profile.bottomOffset = prof["bottomOffset"].toInt();
+        profile.leftOffset = prof["leftOffset"].toInt();
+        profile.rightOffset = prof["rightOffset"].toInt();
+        profile.TLled = prof["TLled"].toInt();
+        profile.TRled = prof["TRled"].toInt();
+        profile.irSensitivity = prof["irSensitivity"].toInt();
+        profile.runMode = prof["runMode"].toInt();
+        profile.layoutType = prof["layoutType"].toBool();
+        profile.color = uint32_t(prof["color"].toVariant().toLongLong());
+        if(config.profiles.length() < PROFILES_MAX) {
+            config.profiles.append(profile);
+        }
+    }
+    config.board.profilesCount = config.profiles.length();
+}
+
+bool gunConfig::Export(const gunConfig_s &config, const QString &path, QString &error)
+{
+    QByteArray data;
+    if(path.endsWith(".json", Qt::CaseInsensitive)) {
+        QJsonObject json;
+        json["format"] = GUNCONFIG_MAGIC;
+        json["version"] = GUNCONFIG_VERSION;
+        ToJson(config, json);
+        data = QJsonDocument(json).toJson();
+    } else {
+        data = GUNCONFIG_MAGIC;
+        QDataStream out(&data, QIODevice::WriteOnly | QIODevice::Append);
+        out.setVersion(QDataStream::Qt_5_15);
+        out << config;
+    }
+
+    QFile file(path);
+    if(!file.open(QIODevice::WriteOnly) || file.write(data) != data.length()) {
+        error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+gunConfigRef gunConfig::Import(const QString &path, QString &error)
+{
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly)) {
+        error = file.errorString();
+        return gunConfigRef();
+    }
+    QByteArray data = file.readAll();
+    gunConfig_s *config = new gunConfig_s;
+    config->inputsMap.fill(-1);
+
+    if(data.startsWith(GUNCONFIG_MAGIC)) {
+        QDataStream in(data.mid(qstrlen(GUNCONFIG_MAGIC)));
+        in.setVersion(QDataStream::Qt_5_15);
+        in >> *config;
+        if(in.status() != QDataStream::Ok) {
+            error = "File is damaged, or from a newer version of the app.";
+            delete config;
+            return gunConfigRef();
+        }
+    } else {
+        QJsonParseError parseError;
+        QJsonObject json = QJsonDocument::fromJson(data, &parseError).object();
+        if(parseError.error != QJsonParseError::NoError || json["format"].toString() != GUNCONFIG_MAGIC) {
+            error = "Not an OpenFIRE config file.";
+            delete config;
+            return gunConfigRef();
+        }
+        if(json["version"].toInt() > GUNCONFIG_VERSION) {
+            error = "File is from a newer version of the app.";
+            delete config;
+            return gunConfigRef();
+        }
+        FromJson(json, *config);
+    }
+    return gunConfigRef(config);
+}
+
+QDataStream &operator<<(QDataStream &out, const gunConfig_s &config)
+{
+    out << quint8(GUNCONFIG_VERSION);
+    out << quint8(config.board.type) << config.board.versionNumber << config.board.versionCodename
+        << quint8(config.board.selectedProfile) << quint8(config.board.profilesCount) << config.boardName;
+    out << config.tinyUSB.tinyUSBid << config.tinyUSB.tinyUSBname;
+    out << quint8(boolTypesCount);
+    for(uint8_t i = 0; i < boolTypesCount; i++) {
+        out << config.boolSettings[i];
+    }
+    out << quint8(boardInputsCount-1);
+    for(uint8_t i = 0; i < boardInputsCount-1; i++) {
+        out << qint8(config.inputsMap[i]);
+    }
+    out << quint8(settingsTypesCount);
+    for(uint8_t i = 0; i < settingsTypesCount; i++) {
+        out << quint32(config.settingsTable[i]);
+    }
+    out << quint8(config.profiles.length());
+    for(const profilesTable_s &profile : config.profiles) {
+        out << quint16(profile.topOffset) << quint16(profile.bottomOffset)
+            << quint16(profile.leftOffset) << quint16(profile.rightOffset)
+            << quint16(profile.TLled) << quint16(profile.TRled)
+            << quint8(profile.irSensitivity) << quint8(profile.runMode) << profile.layoutType
+            << quint32(profile.color) << profile.profName;
+    }
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, gunConfig_s &config)
+{
+    quint8 version, count;
+    in >> version;
+    if(version == 0 || version > GUNCONFIG_VERSION) {
+        in.setStatus(QDataStream::ReadCorruptData);
+        return in;
+    }
+
+    quint8 type, selectedProfile, profilesCount;
+    in >> type >> config.board.versionNumber >> config.board.versionCodename
+       >> selectedProfile >> profilesCount >> config.boardName;
+    // the stored type is only boardTypes_e's order at the time, so go by the firmware's name for it instead.
+    Q_UNUSED(type);
+    config.board.type = config.boardName.isEmpty() ? uint8_t(nothing) : BoardTypeFromName(config.boardName);
+    config.board.selectedProfile = selectedProfile;
+    config.board.previousProfile = selectedProfile;
+    config.board.profilesCount = qMin<quint8>(profilesCount, PROFILES_MAX);
+    in >> config.tinyUSB.tinyUSBid >> config.tinyUSB.tinyUSBname;
+
+    // tables carry their own length, so files from builds that know more (or fewer) of each still line up.
+    in >> count;
+    for(uint8_t i = 0; i < count; i++) {
+        bool value;
+        in >> value;
+        if(i < boolTypesCount) {
+            config.boolSettings[i] = value;
+        }
+    }
+    config.inputsMap.fill(-1);
+    in >> count;
+    for(uint8_t i = 0; i < count; i++) {
+        qint8 pin;
+        in >> pin;
+        if(i < boardInputsCount-1) {
+            config.inputsMap[i] = pin;
+        }
+    }
+    for(uint8_t i = 0; i < settingsTypesCount; i++) {
+        config.settingsTable[i] = settingsSchema[i].def;
+    }
+    in >> count;
+    for(uint8_t i = 0; i < count; i++) {
+        quint32 value;
+        in >> value;
+        if(i < settingsTypesCount) {
+            config.settingsTable[i] = value;
+        }
+    }
+    in >> count;
+    config.profiles.resize(qMin<quint8>(count, PROFILES_MAX));
+    for(uint8_t i = 0; i < count; i++) {
+        quint16 top, bottom, left, right, TLled, TRled;
+        quint8 irSensitivity, runMode;
+        bool layoutType;
+        quint32 color;
+        QString name;
+        in >> top >> bottom >> left >> right >> TLled >> TRled >> irSensitivity >> runMode >> layoutType >> color >> name;
+        if(i < config.profiles.length()) {
+            profilesTable_s &profile = config.profiles[i];
+            profile.topOffset = top;
+            profile.bottomOffset = bottom;
+            profile.leftOffset = left;
+            profile.rightOffset = right;
+            profile.TLled = TLled;
+            profile.TRled = TRled;
+            profile.irSensitivity = irSensitivity;
+            profile.runMode = runMode;
+            profile.layoutType = layoutType;
+            profile.color = color;
+            profile.profName = name;
+        }
+    }
+    return in;
+}
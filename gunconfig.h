@@ -0,0 +1,101 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef GUNCONFIG_H
+#define GUNCONFIG_H
+
+#include "constants.h"
+#include <QByteArrayList>
+#include <QDataStream>
+#include <QJsonObject>
+#include <QSharedPointer>
+#include <QVector>
+#include <array>
+
+class QSerialPort;
+
+// A gun's replies to a full config load, exactly as they came off the wire.
+// Nothing in here is parsed yet, so it's cheap to collect & safe to hand to another thread.
+typedef struct gunReplies_t {
+    QByteArray handshake;      // XP
+    QByteArray tinyUSB;        // Xli
+    QByteArray bools;          // Xlb
+    QByteArray pins;           // Xlp, only asked for if customPins is on
+    QByteArray settings;       // Xls
+    QByteArrayList profiles;   // XlP<n>, one per profile the handshake reported
+} gunReplies_s;
+
+// Everything a gun's config is, as decoded from one set of replies.
+typedef struct gunConfig_t {
+    boardInfo_s board;
+    // as reported by the firmware, e.g. "rpipico"
+    QString boardName;
+    tinyUSBtable_s tinyUSB;
+    bool boolSettings[boolTypesCount] = {};
+    // -1 = unmapped, same as inputsMap. All unmapped if customPins isn't set.
+    std::array<int8_t, boardInputsCount-1> inputsMap;
+    // As the gun has them, out of range or not; settings the firmware didn't send are at their default.
+    uint32_t settingsTable[settingsTypesCount] = {};
+    QVector<profilesTable_s> profiles;
+    // First reply that didn't make sense, if any; empty means it all decoded.
+    QString error;
+} gunConfig_s;
+
+// Snapshots are never changed once decoded, so any number of readers (the window, logger, exporter, audit)
+// can hold the same one. Anyone wanting a different config copies it, changes the copy, and shares that instead.
+typedef QSharedPointer<const gunConfig_s> gunConfigRef;
+
+typedef enum {
+    queryOk = 0,
+    queryNoWrite,
+    queryNoReply,
+    queryNoCamera,
+    queryNotOpenFIRE
+} gunQuery_e;
+
+namespace gunConfig {
+
+// Runs the whole load sequence (XP, Xli, Xlb, Xlp, Xls, XlP<n>) over an open port, collecting the raw replies.
+// Blocking, on whatever thread owns the port. Only looks at as much of the replies as it needs to know what to ask next.
+gunQuery_e Query(QSerialPort &port, gunReplies_s &replies);
+
+// Turns a set of replies into a snapshot. Touches nothing else, so it can run on any thread.
+gunConfigRef Decode(const gunReplies_s &replies);
+
+// Adds the config's fields (firmware, board, toggles, pins, settings, profiles...) to json, next to whatever's there.
+// Same layout as a gun's entry in an audit report, so either can be read as the other.
+void ToJson(const gunConfig_s &config, QJsonObject &json);
+
+// Anything json doesn't have comes out unmapped, or at its default.
+void FromJson(const QJsonObject &json, gunConfig_s &config);
+
+// Writes a config file: JSON (for reading over) if path ends in .json, the binary form below otherwise.
+bool Export(const gunConfig_s &config, const QString &path, QString &error);
+
+// Reads either kind of config file, whichever it turns out to be; null (with error set) if it can't.
+gunConfigRef Import(const QString &path, QString &error);
+
+}
+
+// Compact binary form of a config, as kept in the local store and exported files.
+// Leads with GUNCONFIG_VERSION; reading anything newer (or cut short) sets the stream's status instead.
+// error isn't included.
+QDataStream &operator<<(QDataStream &out, const gunConfig_s &config);
+
+QDataStream &operator>>(QDataStream &in, gunConfig_s &config);
+
+#endif // GUNCONFIG_H
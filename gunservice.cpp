@@ -0,0 +1,458 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "gunservice.h"
+#include "ffrelay.h"
+#include "constants.h"
+#include <QSerialPortInfo>
+#include <QTimer>
+#include <QtDebug>
+
+gunService::gunService(QObject *parent)
+    : QObject(parent)
+{
+    connect(&server, &QLocalServer::newConnection, this, &gunService::server_newConnection);
+    aliveTimer = new QTimer(this);
+    connect(aliveTimer, &QTimer::timeout, this, &gunService::aliveTimer_timeout);
+}
+
+gunService::~gunService()
+{
+    // let every gun go back to normal operation on the way out.
+    for(const QString &path : guns.keys()) {
+        PortClose(path);
+    }
+    // no event loop left to finish undocking on, so get the XEs out before the ports go.
+    for(const QPointer<QSerialPort> &port : std::as_const(undocking)) {
+        if(port && port->isOpen()) {
+            port->waitForBytesWritten(500);
+            port->close();
+        }
+    }
+}
+
+bool gunService::Start(bool withRelay)
+{
+    // Is there already one of us running?
+    QLocalSocket probe;
+    probe.connectToServer(SERVICE_NAME);
+    if(probe.waitForConnected(100)) {
+        qDebug() << "Service is already running, bailing out.";
+        return false;
+    }
+    // clean up a stale socket file left behind by a crashed service.
+    QLocalServer::removeServer(SERVICE_NAME);
+    if(!server.listen(SERVICE_NAME)) {
+        qDebug() << "Couldn't listen on" << SERVICE_NAME << "-" << server.errorString();
+        return false;
+    }
+    qDebug() << "Service listening @" << server.fullServerName();
+    if(withRelay) {
+        relay = new ffRelay(this);
+        if(!relay->Start()) {
+            return false;
+        }
+    }
+    PortsRescan();
+    aliveTimer->start(ALIVE_TIMER);
+    return true;
+}
+
+QStringList gunService::GunPaths() const
+{
+    QStringList paths;
+    for(auto gun = guns.cbegin(); gun != guns.cend(); ++gun) {
+        if(!gun->released && gun->handshakeDone) {
+            paths.append(gun.key());
+        }
+    }
+    return paths;
+}
+
+QSerialPort *gunService::GunPort(const QString &path) const
+{
+    auto gun = guns.constFind(path);
+    if(gun == guns.cend() || gun->released || !gun->handshakeDone) {
+        return nullptr;
+    }
+    return gun->port;
+}
+
+bool gunService::GunBusy(const QString &path) const
+{
+    auto gun = guns.constFind(path);
+    return gun == guns.cend() || gun->busy || gun->settling || !gun->handshakeDone;
+}
+
+bool gunService::RequestPort(const QString &portPath, bool release)
+{
+    QLocalSocket socket;
+    socket.connectToServer(SERVICE_NAME);
+    if(!socket.waitForConnected(100)) {
+        return false;
+    }
+    socket.write(QString("%1 %2\n").arg(release ? "RELEASE" : "ACQUIRE", portPath).toLocal8Bit());
+    socket.waitForBytesWritten(1000);
+    // undocking waits on the gun, so give it about as long as the GUI would.
+    while(socket.waitForReadyRead(3000)) {
+        while(socket.canReadLine()) {
+            QByteArray reply = socket.readLine().trimmed();
+            if(reply.startsWith("OK:") || reply.startsWith("ERR:")) {
+                return reply.startsWith("OK:");
+            }
+        }
+    }
+    return false;
+}
+
+void gunService::server_newConnection()
+{
+    while(server.hasPendingConnections()) {
+        QLocalSocket *client = server.nextPendingConnection();
+        connect(client, &QLocalSocket::readyRead, this, &gunService::client_readyRead);
+        connect(client, &QLocalSocket::disconnected, this, &gunService::client_disconnected);
+    }
+}
+
+void gunService::client_readyRead()
+{
+    QLocalSocket *client = qobject_cast<QLocalSocket*>(sender());
+    if(!client) {
+        return;
+    }
+    while(client->canReadLine()) {
+        ClientCommand(client, client->readLine().trimmed());
+    }
+}
+
+void gunService::client_disconnected()
+{
+    QLocalSocket *client = qobject_cast<QLocalSocket*>(sender());
+    if(!client) {
+        return;
+    }
+    for(auto gun = guns.begin(); gun != guns.end(); ++gun) {
+        gun->subscribers.removeAll(client);
+    }
+    // pending requests hold a QPointer, so whatever's left in the queues just gets its reply dropped.
+    client->deleteLater();
+}
+
+void gunService::ClientCommand(QLocalSocket *client, const QByteArray &line)
+{
+    QList<QByteArray> args = line.split(' ');
+    const QByteArray verb = args[0].toUpper();
+
+    if(verb == "LIST") {
+        for(auto gun = guns.cbegin(); gun != guns.cend(); ++gun) {
+            if(!gun->released && gun->handshakeDone) {
+                client->write(QString("GUN:%1,%2\n").arg(gun.key(), gun->handshake).toLocal8Bit());
+            }
+        }
+        client->write("OK:LIST\n");
+        return;
+    }
+
+    if(args.length() < 2) {
+        client->write("ERR:MISSINGPORT\n");
+        return;
+    }
+    const QString path = QString::fromLocal8Bit(args[1]);
+    if(!guns.contains(path)) {
+        client->write(QString("ERR:NOPORT:%1\n").arg(path).toLocal8Bit());
+        return;
+    }
+    gunPort_s &gun = guns[path];
+
+    if(verb == "RELEASE") {
+        // only OK once it's closed, since the client's about to open it.
+        QPointer<QLocalSocket> asker(client);
+        guns[path].released = true;
+        PortClose(path, [asker, path]() {
+            if(asker) {
+                asker->write(QString("OK:RELEASE:%1\n").arg(path).toLocal8Bit());
+            }
+        });
+    } else if(verb == "ACQUIRE") {
+        gun.released = false;
+        if(PortOpen(path)) {
+            client->write(QString("OK:ACQUIRE:%1\n").arg(path).toLocal8Bit());
+        } else {
+            client->write(QString("ERR:ACQUIRE:%1\n").arg(path).toLocal8Bit());
+        }
+    } else if(gun.released || !gun.port) {
+        client->write(QString("ERR:RELEASED:%1\n").arg(path).toLocal8Bit());
+    } else if(verb == "SUB") {
+        if(!gun.subscribers.contains(client)) {
+            gun.subscribers.append(client);
+        }
+        client->write(QString("OK:SUB:%1\n").arg(path).toLocal8Bit());
+    } else if(verb == "UNSUB") {
+        gun.subscribers.removeAll(client);
+        client->write(QString("OK:UNSUB:%1\n").arg(path).toLocal8Bit());
+    } else if(verb == "SEND") {
+        // everything after the port is the command, verbatim.
+        QByteArray command = line.mid(args[0].length() + 1 + args[1].length()).trimmed();
+        if(command.isEmpty()) {
+            client->write("ERR:MISSINGCMD\n");
+        // undocking is the service's job, not the client's.
+        } else if(command == "XE") {
+            client->write("ERR:FORBIDDEN:XE\n");
+        } else {
+            gunRequest_s request;
+            request.client = client;
+            request.command = command;
+            gun.pending.enqueue(request);
+            RequestNext(path);
+        }
+    } else {
+        client->write(QString("ERR:UNKNOWN:%1\n").arg(QString::fromLocal8Bit(verb)).toLocal8Bit());
+    }
+}
+
+void gunService::PortsRescan()
+{
+    const QList<QSerialPortInfo> portsList = QSerialPortInfo::availablePorts();
+    QStringList foundPaths;
+    for(const QSerialPortInfo &info : portsList) {
+        if(info.vendorIdentifier() == 0xF143) {
+            foundPaths.append(info.systemLocation());
+            if(!guns.contains(info.systemLocation())) {
+                qDebug() << "Found device @" << info.systemLocation();
+                guns[info.systemLocation()] = gunPort_s();
+                PortOpen(info.systemLocation());
+            }
+        }
+    }
+    // drop whatever got unplugged.
+    for(const QString &path : guns.keys()) {
+        if(!foundPaths.contains(path)) {
+            qDebug() << "Lost device @" << path;
+            PortClose(path);
+            if(guns[path].requestTimer) {
+                guns[path].requestTimer->deleteLater();
+                guns[path].quietTimer->deleteLater();
+            }
+            guns.remove(path);
+        }
+    }
+}
+
+bool gunService::PortOpen(const QString &path)
+{
+    gunPort_s &gun = guns[path];
+    if(gun.port) {
+        return true;
+    }
+    gun.port = new QSerialPort(path, this);
+    gun.port->setBaudRate(QSerialPort::Baud9600);
+    if(!gun.port->open(QIODevice::ReadWrite)) {
+        qDebug() << "Couldn't open" << path << "- is something else holding it?";
+        delete gun.port;
+        gun.port = nullptr;
+        return false;
+    }
+    // windows needs DTR enabled to actually read responses.
+    gun.port->setDataTerminalReady(true);
+    connect(gun.port, &QSerialPort::readyRead, this, &gunService::gun_readyRead);
+    if(!gun.requestTimer) {
+        gun.requestTimer = new QTimer(this);
+        gun.requestTimer->setSingleShot(true);
+        connect(gun.requestTimer, &QTimer::timeout, this, [this, path]() {
+            RequestFinish(path, "ERR:TIMEOUT");
+        });
+        gun.quietTimer = new QTimer(this);
+        gun.quietTimer->setSingleShot(true);
+        connect(gun.quietTimer, &QTimer::timeout, this, [this, path]() {
+            if(!guns.contains(path)) {
+                return;
+            }
+            guns[path].settling = false;
+            guns[path].timedOut = false;
+            // anything held back for the gun (i.e. force feedback) goes out before the next request.
+            emit gunIdle(path);
+            RequestNext(path);
+        });
+    }
+    // Docks the gun; the reply gets picked up in gun_readyRead.
+    gun.handshakeDone = false;
+    gun.port->write("XP");
+    return true;
+}
+
+void gunService::PortClose(const QString &path, std::function<void()> closed)
+{
+    gunPort_s &gun = guns[path];
+    if(gun.requestTimer) {
+        gun.requestTimer->stop();
+        gun.quietTimer->stop();
+    }
+    for(const gunRequest_s &request : std::as_const(gun.pending)) {
+        if(request.client) {
+            request.client->write(QString("ERR:CLOSED:%1\n").arg(path).toLocal8Bit());
+        }
+    }
+    gun.pending.clear();
+    gun.busy = false;
+    if(gun.port) {
+        QSerialPort *port = gun.port;
+        gun.port = nullptr;
+        disconnect(port, nullptr, this, nullptr);
+        if(port->isOpen()) {
+            // the gun acks XE with a line; close on that, or after a while if it never comes (e.g. it's been unplugged),
+            // without holding up every other gun and client in the meantime.
+            undocking.removeAll(QPointer<QSerialPort>());
+            undocking.append(port);
+            port->write("XE");
+            auto finish = [port, closed]() {
+                if(port->isOpen()) {
+                    port->readAll();
+                    port->close();
+                    if(closed) {
+                        closed();
+                    }
+                }
+                port->deleteLater();
+            };
+            connect(port, &QSerialPort::readyRead, port, [port, finish]() {
+                if(port->canReadLine()) {
+                    finish();
+                }
+            });
+            QTimer::singleShot(2000, port, finish);
+        } else {
+            port->deleteLater();
+            if(closed) {
+                closed();
+            }
+        }
+    } else if(closed) {
+        closed();
+    }
+    gun.settling = false;
+    gun.timedOut = false;
+    gun.handshakeDone = false;
+    emit gunClosed(path);
+}
+
+void gunService::RequestNext(const QString &path)
+{
+    gunPort_s &gun = guns[path];
+    // hold off until the gun's docked, else its handshake gets mistaken for a reply.
+    if(gun.busy || gun.settling || !gun.handshakeDone || gun.pending.isEmpty() || !gun.port) {
+        return;
+    }
+    gun.busy = true;
+    gun.port->write(gun.pending.head().command);
+    gun.requestTimer->start(2000);
+}
+
+void gunService::RequestFinish(const QString &path, const QByteArray &reply)
+{
+    if(!guns.contains(path)) {
+        return;
+    }
+    gunPort_s &gun = guns[path];
+    gun.requestTimer->stop();
+    if(!gun.busy || gun.pending.isEmpty()) {
+        return;
+    }
+    gunRequest_s request = gun.pending.dequeue();
+    gun.busy = false;
+    gun.settling = true;
+    gun.timedOut = reply == "ERR:TIMEOUT";
+    gun.settleClock.start();
+    gun.quietTimer->start(SERVICE_QUIET_TIMER);
+    if(request.client) {
+        if(reply.startsWith("ERR:")) {
+            request.client->write(reply + ":" + path.toLocal8Bit() + "\n");
+        } else {
+            request.client->write("RE:" + path.toLocal8Bit() + ":" + reply + "\n");
+        }
+    }
+}
+
+// Something came in while settling, so wait for it to go quiet again; just not past SERVICE_SETTLE_MAX in all.
+void gunService::SettleExtend(gunPort_s &gun)
+{
+    qint64 remaining = SERVICE_SETTLE_MAX - gun.settleClock.elapsed();
+    if(remaining > 0) {
+        gun.quietTimer->start(qMin<qint64>(remaining, SERVICE_QUIET_TIMER));
+    }
+}
+
+void gunService::gun_readyRead()
+{
+    // Demultiplexing to figure out which gun is talking.
+    QSerialPort *port = qobject_cast<QSerialPort*>(sender());
+    QString path;
+    for(auto gun = guns.cbegin(); gun != guns.cend(); ++gun) {
+        if(gun->port == port) {
+            path = gun.key();
+            break;
+        }
+    }
+    if(path.isEmpty()) {
+        return;
+    }
+
+    while(guns[path].port && guns[path].port->canReadLine()) {
+        gunPort_s &gun = guns[path];
+        QByteArray line = gun.port->readLine().trimmed();
+        if(line.isEmpty()) {
+            continue;
+        }
+        if(!gun.handshakeDone) {
+            if(line.contains("OpenFIRE")) {
+                gun.handshake = QString::fromLocal8Bit(line);
+                gun.handshakeDone = true;
+                qDebug() << "Docked" << path << "-" << gun.handshake;
+                emit gunIdle(path);
+                RequestNext(path);
+            }
+        } else if(gun.busy) {
+            // first line back belongs to whoever asked; anything trailing (e.g. XS's
+            // "Settings saved to...") falls through to subscribers as a normal event.
+            RequestFinish(path, line);
+        } else if(gun.settling && gun.timedOut) {
+            // a reply to a request that's already been given up on; nobody's waiting for it.
+            SettleExtend(gun);
+        } else {
+            if(gun.settling) {
+                SettleExtend(gun);
+            }
+            for(const QPointer<QLocalSocket> &client : std::as_const(gun.subscribers)) {
+                if(client) {
+                    client->write("EV:" + path.toLocal8Bit() + ":" + line + "\n");
+                }
+            }
+        }
+    }
+}
+
+void gunService::aliveTimer_timeout()
+{
+    // picks up newly plugged guns, and retries ones that failed to open.
+    PortsRescan();
+    for(auto gun = guns.begin(); gun != guns.end(); ++gun) {
+        if(!gun->released && !gun->port) {
+            PortOpen(gun.key());
+        } else if(gun->port && !gun->busy && !gun->settling) {
+            gun->port->write(".");
+        }
+    }
+}
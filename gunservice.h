@@ -0,0 +1,143 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef GUNSERVICE_H
+#define GUNSERVICE_H
+
+#include <QObject>
+#include <QSerialPort>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QPointer>
+#include <QElapsedTimer>
+#include <QQueue>
+#include <QTimer>
+#include <QMap>
+#include <functional>
+
+class ffRelay;
+
+// Background service that holds every OpenFIRE port docked and shares them
+// between any number of local clients (frontends, emulator plugins, the GUI).
+//
+// Protocol is plain text, one command per line, in the same spirit as the gun's own:
+//   LIST                   -> "GUN:<port>,<handshake>" for every docked gun, then "OK:LIST"
+//   SEND <port> <command>  -> "RE:<port>:<first line of the gun's reply>", or "ERR:..."
+//   SUB <port>             -> from now on, "EV:<port>:<line>" for every unsolicited line
+//   UNSUB <port>           -> stop the above
+//   RELEASE <port>         -> undock & close the port so another process can open it
+//   ACQUIRE <port>         -> take a released port back and redock it
+// Config queries are just SENDs of Xl* commands; config changes are Xm.* and XS.
+class gunService : public QObject
+{
+    Q_OBJECT
+
+public:
+    gunService(QObject *parent = nullptr);
+    ~gunService();
+
+    // Returns false if another service is already listening.
+    // withRelay also opens up the force feedback relay socket (see ffrelay.h).
+    bool Start(bool withRelay = false);
+
+    // Docked guns, in the order clients see them from LIST.
+    QStringList GunPaths() const;
+
+    // nullptr if the port isn't docked (released, unplugged, or failed to open).
+    QSerialPort *GunPort(const QString &path) const;
+
+    // True while a gun is docking, waiting on a reply to a client's request, or still settling after one.
+    bool GunBusy(const QString &path) const;
+
+    // Client-side helper: asks a running service to release (or reacquire) a port.
+    // Returns false if there's no service around, in which case nothing needs doing.
+    static bool RequestPort(const QString &portPath, bool release);
+
+signals:
+    // A gun just finished docking or answering a request (and has gone quiet since), and nothing's on the wire.
+    void gunIdle(const QString &path);
+
+    // A gun's port was closed (released, unplugged, or the service is on its way out).
+    void gunClosed(const QString &path);
+
+private slots:
+    void server_newConnection();
+
+    void client_readyRead();
+
+    void client_disconnected();
+
+    void gun_readyRead();
+
+    void aliveTimer_timeout();
+
+private:
+    typedef struct gunRequest_t {
+        QPointer<QLocalSocket> client;
+        QByteArray command;
+    } gunRequest_s;
+
+    typedef struct gunPort_t {
+        QSerialPort *port = nullptr;
+        // the gun's reply to "XP", kept around so LIST doesn't need a round trip.
+        QString handshake;
+        bool handshakeDone = false;
+        // set when a client asked to borrow this port.
+        bool released = false;
+        // Requests are serialized per gun, since replies aren't tagged.
+        QQueue<gunRequest_s> pending;
+        bool busy = false;
+        QTimer *requestTimer = nullptr;
+        // Set between a request finishing and the gun going quiet, so trailing or late lines aren't taken as the next reply.
+        bool settling = false;
+        // the last request got no reply in time, so whatever turns up while settling is its, and gets dropped.
+        bool timedOut = false;
+        QTimer *quietTimer = nullptr;
+        // since settling started, to cut it off at SERVICE_SETTLE_MAX.
+        QElapsedTimer settleClock;
+        QList<QPointer<QLocalSocket>> subscribers;
+    } gunPort_s;
+
+    QLocalServer server;
+
+    // Key = system location of the port (e.g. /dev/ttyACM0, COM3)
+    QMap<QString, gunPort_s> guns;
+
+    QTimer *aliveTimer;
+
+    ffRelay *relay = nullptr;
+
+    // Ports sent XE and waiting on the gun's ack before they're closed; see PortClose().
+    QList<QPointer<QSerialPort>> undocking;
+
+    void ClientCommand(QLocalSocket *client, const QByteArray &line);
+
+    void PortsRescan();
+
+    bool PortOpen(const QString &path);
+
+    // Undocks without waiting on the gun; closed is called once the port's actually let go of.
+    void PortClose(const QString &path, std::function<void()> closed = nullptr);
+
+    void RequestNext(const QString &path);
+
+    void RequestFinish(const QString &path, const QByteArray &reply);
+
+    void SettleExtend(gunPort_s &gun);
+};
+
+#endif // GUNSERVICE_H
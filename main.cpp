@@ -16,14 +16,68 @@
 */
 
 #include "guiwindow.h"
+#include "gunservice.h"
+#include "fleetaudit.h"
+#include "configstore.h"
+#include "singleinstance.h"
+#include "startupprofile.h"
 
 #include <QApplication>
+#include <QCoreApplication>
+#include <QFileInfo>
 #include <QLocale>
 #include <QTranslator>
 
 int main(int argc, char *argv[])
 {
+    bool profileStartup = false;
+    for(int i = 1; i < argc; i++) {
+        if(qstrcmp(argv[i], "--startup-profile") == 0) {
+            profileStartup = true;
+        }
+    }
+    startupProfile::Begin(profileStartup);
+
+    // Service, audit & store modes don't need (or want) a display, so check for them before any GUI bits get spun up.
+    for(int i = 1; i < argc; i++) {
+        if(qstrcmp(argv[i], "--daemon") == 0) {
+            QCoreApplication service(argc, argv);
+            gunService gunSvc;
+            if(!gunSvc.Start(service.arguments().contains("--relay"))) {
+                return 1;
+            }
+            return service.exec();
+        } else if(qstrcmp(argv[i], "--audit") == 0 && i+1 < argc) {
+            QCoreApplication audit(argc, argv);
+            QString goldenSpec;
+            int golden = audit.arguments().indexOf("--golden");
+            if(golden > 0 && golden+1 < audit.arguments().length()) {
+                goldenSpec = audit.arguments()[golden+1];
+            }
+            return fleetAudit::Run(QString::fromLocal8Bit(argv[i+1]), goldenSpec);
+        } else if(qstrcmp(argv[i], "--store") == 0) {
+            QCoreApplication store(argc, argv);
+            return configStore::Run(store.arguments().mid(store.arguments().indexOf("--store") + 1));
+        }
+    }
+
     QApplication a(argc, argv);
+    startupProfile::Mark("application");
+
+    // the open instance may be running from somewhere else entirely, so file paths need to be absolute.
+    QStringList args = a.arguments().mid(1);
+    int apply = args.indexOf("--apply");
+    if(apply >= 0 && apply+1 < args.length()) {
+        args[apply+1] = QFileInfo(args[apply+1]).absoluteFilePath();
+    }
+
+    // If we're already open, pass along what we were asked to do and get out of the way.
+    singleInstance instance;
+    if(instance.HandOff(args)) {
+        return 0;
+    }
+    instance.Listen();
+    startupProfile::Mark("single instance check");
 
     QTranslator translator;
     const QStringList uiLanguages = QLocale::system().uiLanguages();
@@ -34,7 +88,11 @@ int main(int argc, char *argv[])
             break;
         }
     }
+    startupProfile::Mark("translations");
     guiWindow w;
+    QObject::connect(&instance, &singleInstance::argumentsReceived, &w, &guiWindow::HandleArguments);
     w.show();
+    startupProfile::Mark("window shown");
+    w.HandleArguments(args);
     return a.exec();
 }
@@ -0,0 +1,66 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "pinfunctions.h"
+
+pinFunctionsProxy::pinFunctionsProxy(uint64_t functions, QAbstractItemModel *source, QObject *parent)
+    : QSortFilterProxyModel(parent)
+    , functions(functions)
+{
+    for(int i = 63; i >= 0; i--) {
+        if(functions & (1ULL << i)) {
+            lastRow = i;
+            break;
+        }
+    }
+    setSourceModel(source);
+}
+
+
+bool pinFunctionsProxy::Allowed(int row) const
+{
+    return row >= 0 && row < 64 && (functions & (1ULL << row));
+}
+
+
+bool pinFunctionsProxy::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    Q_UNUSED(sourceParent);
+    return sourceRow <= lastRow;
+}
+
+
+QVariant pinFunctionsProxy::data(const QModelIndex &index, int role) const
+{
+    if(index.isValid() && !Allowed(mapToSource(index).row())) {
+        // same as what QComboBox::insertSeparator() leaves behind.
+        if(role == Qt::AccessibleDescriptionRole) {
+            return QString("separator");
+        }
+        return QVariant();
+    }
+    return QSortFilterProxyModel::data(index, role);
+}
+
+
+Qt::ItemFlags pinFunctionsProxy::flags(const QModelIndex &index) const
+{
+    if(index.isValid() && !Allowed(mapToSource(index).row())) {
+        return Qt::NoItemFlags;
+    }
+    return QSortFilterProxyModel::flags(index);
+}
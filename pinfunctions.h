@@ -0,0 +1,52 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef PINFUNCTIONS_H
+#define PINFUNCTIONS_H
+
+#include <QSortFilterProxyModel>
+
+// View of the shared pin functions list (valuesNameList) for pin boxes with the same capabilities.
+// Row numbers have to stay equal to boardInputs_e, since that's what the boxes' indexes are used as,
+// so functions a pin can't take are shown as separators - except past the last one it can take,
+// where they're just left off the end.
+class pinFunctionsProxy : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    // functions is a mask as made by PinFunctionsMask()
+    pinFunctionsProxy(uint64_t functions, QAbstractItemModel *source, QObject *parent = nullptr);
+
+    uint64_t Functions() const { return functions; }
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    uint64_t functions;
+    // highest function in the mask; nothing after it gets a row.
+    int lastRow = -1;
+
+    bool Allowed(int row) const;
+};
+
+#endif // PINFUNCTIONS_H
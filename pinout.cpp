@@ -0,0 +1,82 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "pinout.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <QtDebug>
+
+QVector<pinoutSlot_s> pinout::Load(const QString &path)
+{
+    static QHash<QString, QVector<pinoutSlot_s>> cache;
+    auto cached = cache.constFind(path);
+    if(cached != cache.constEnd()) {
+        return cached.value();
+    }
+
+    QVector<pinoutSlot_s> layoutSlots;
+    // a pinout of the same name in the app's data folder wins over the built-in one,
+    // so boards can be fixed up (or new ones tried out) without rebuilding.
+    QString override = QStandardPaths::locate(QStandardPaths::AppDataLocation, "pinouts/" + QFileInfo(path).fileName());
+    QFile file(override.isEmpty() ? path : override);
+    if(!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qDebug() << "Couldn't open pinout" << file.fileName();
+        return layoutSlots;
+    }
+    QTextStream stream(&file);
+    uint16_t lineNum = 0;
+    while(!stream.atEnd()) {
+        lineNum++;
+        QString line = stream.readLine().section('#', 0, 0).simplified();
+        if(line.isEmpty()) {
+            continue;
+        }
+        QStringList fields = line.split(' ');
+        bool posOk = false, gpioOk = true;
+        pinoutSlot_s slot;
+        if(fields.length() == 3) {
+            slot.position = fields[1].toUShort(&posOk);
+            if(fields[2] == "-") {
+                slot.gpio = -1;
+            } else {
+                slot.gpio = fields[2].toShort(&gpioOk);
+                gpioOk = gpioOk && slot.gpio >= 0 && slot.gpio < 30;
+            }
+        }
+        if(fields[0] == "L") {
+            slot.side = pinoutLeft;
+        } else if(fields[0] == "R") {
+            slot.side = pinoutRight;
+        } else if(fields[0] == "C") {
+            slot.side = pinoutCenter;
+            // nothing to pad out in the center strip
+            gpioOk = gpioOk && slot.gpio >= 0;
+        } else {
+            posOk = false;
+        }
+        if(!posOk || !gpioOk) {
+            qDebug() << "Bad slot in pinout" << file.fileName() << "at line" << lineNum << ":" << line;
+            continue;
+        }
+        layoutSlots.append(slot);
+    }
+    cache.insert(path, layoutSlots);
+    return layoutSlots;
+}
@@ -0,0 +1,50 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef PINOUT_H
+#define PINOUT_H
+
+#include <QString>
+#include <QVector>
+
+// Where a board's pin boxes go around its picture, loaded from a pinout resource
+// (see pinouts/pico.pinout for the format) rather than hand-placed per board.
+
+enum pinoutSides_e {
+    pinoutLeft = 0,
+    pinoutRight,
+    pinoutCenter
+};
+
+typedef struct pinoutSlot_t {
+    uint8_t side;
+    // grid row for the sides, grid column for the center strip
+    uint8_t position;
+    // -1 = spacer
+    int8_t gpio;
+} pinoutSlot_s;
+
+namespace pinout {
+
+// Parsed once per resource, then served from cache.
+// A file of the same name under <app data>/pinouts/ takes precedence over the resource.
+// Empty if the resource is missing; malformed lines are skipped.
+QVector<pinoutSlot_s> Load(const QString &path);
+
+}
+
+#endif // PINOUT_H
@@ -0,0 +1,157 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "pinsolver.h"
+#include <bitset>
+
+// Gives up after this many placements. Real layouts are solved in well under a hundred,
+// this only stops a hopeless request from chewing through every permutation.
+#define SOLVER_STEPS_MAX 200000
+
+typedef struct solverState_t {
+    // per function, the pins it's allowed on
+    uint32_t candidates[boardInputsCount];
+    // per function, where the board's default layout puts it (-1 if nowhere)
+    int8_t defaultPins[boardInputsCount];
+    // functions still waiting on a pin
+    uint64_t open;
+    // pins already handed out
+    uint32_t used;
+    // functions that ran out of pins at some point
+    uint64_t stuck;
+    uint32_t steps;
+    std::array<int8_t, boardInputsCount-1> inputsMap;
+} solverState_s;
+
+static uint8_t PinsCount(uint32_t pins)
+{
+    return std::bitset<32>(pins).count();
+}
+
+static bool Place(solverState_s &state)
+{
+    if(!state.open) {
+        return true;
+    }
+    if(++state.steps > SOLVER_STEPS_MAX) {
+        return false;
+    }
+
+    // most constrained function goes first, so dead ends show up as early as possible.
+    uint8_t function = 0;
+    uint8_t fewest = 33;
+    for(uint8_t i = 1; i < boardInputsCount; i++) {
+        if(state.open & (1ULL << i)) {
+            uint8_t count = PinsCount(state.candidates[i] & ~state.used);
+            if(count < fewest) {
+                function = i;
+                fewest = count;
+            }
+        }
+    }
+    if(!fewest) {
+        state.stuck |= 1ULL << function;
+        return false;
+    }
+
+    uint32_t options = state.candidates[function] & ~state.used;
+    state.open &= ~(1ULL << function);
+    // its default spot first, then pins that aren't anyone else's default, then the rest; lowest pin first.
+    uint32_t claimed = 0;
+    for(uint8_t i = 1; i < boardInputsCount; i++) {
+        if((state.open & (1ULL << i)) && state.defaultPins[i] >= 0) {
+            claimed |= 1UL << state.defaultPins[i];
+        }
+    }
+    int8_t order[30];
+    uint8_t count = 0;
+    int8_t preferred = state.defaultPins[function];
+    if(preferred >= 0 && (options & (1UL << preferred))) {
+        order[count++] = preferred;
+        options &= ~(1UL << preferred);
+    }
+    for(uint32_t pass : {options & ~claimed, options & claimed}) {
+        for(uint8_t pin = 0; pin < 30; pin++) {
+            if(pass & (1UL << pin)) {
+                order[count++] = pin;
+            }
+        }
+    }
+    for(uint8_t i = 0; i < count; i++) {
+        state.used |= 1UL << order[i];
+        state.inputsMap[function-1] = order[i];
+        if(Place(state)) {
+            return true;
+        }
+        state.used &= ~(1UL << order[i]);
+    }
+    state.inputsMap[function-1] = -1;
+    state.open |= 1ULL << function;
+    return false;
+}
+
+pinSolution_s pinSolver::Solve(const boardDesc_s &board, uint64_t required, const int8_t *pinned)
+{
+    pinSolution_s solution;
+    solverState_s state = {};
+    state.inputsMap.fill(-1);
+
+    for(uint8_t i = 0; i < boardInputsCount; i++) {
+        state.defaultPins[i] = -1;
+    }
+    for(uint8_t pin = 0; pin < 30; pin++) {
+        if(board.layout[pin].pinAssignment > btnUnmapped) {
+            state.defaultPins[board.layout[pin].pinAssignment] = pin;
+        }
+        if(board.usablePins & (1UL << pin)) {
+            uint64_t functions = PinFunctionsMask(pin, board.analogPins & (1UL << pin));
+            for(uint8_t i = 1; i < boardInputsCount; i++) {
+                if(functions & (1ULL << i)) {
+                    state.candidates[i] |= 1UL << pin;
+                }
+            }
+        }
+    }
+
+    // pinned choices go in as they are, as long as they're legal in the first place.
+    for(uint8_t i = 1; i < boardInputsCount; i++) {
+        int8_t pin = pinned ? pinned[i-1] : -1;
+        if(pin < 0) {
+            continue;
+        }
+        if(pin >= 30 || !(state.candidates[i] & (1UL << pin)) || (state.used & (1UL << pin))) {
+            solution.conflicts |= 1ULL << i;
+        } else {
+            state.used |= 1UL << pin;
+            state.inputsMap[i-1] = pin;
+        }
+        required &= ~(1ULL << i);
+    }
+    if(solution.conflicts) {
+        solution.inputsMap = state.inputsMap;
+        return solution;
+    }
+
+    // bit 0 is "unmapped", which doesn't need a pin.
+    state.open = required & ((1ULL << boardInputsCount) - 1) & ~1ULL;
+    solution.solved = Place(state);
+    solution.inputsMap = state.inputsMap;
+    if(!solution.solved) {
+        solution.conflicts = state.stuck ? state.stuck : state.open;
+    }
+    return solution;
+}
@@ -0,0 +1,43 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef PINSOLVER_H
+#define PINSOLVER_H
+
+#include "constants.h"
+#include <array>
+
+typedef struct pinSolution_t {
+    bool solved = false;
+    // same layout as inputsMap: index = function-1, value = pin, or -1 if unmapped.
+    std::array<int8_t, boardInputsCount-1> inputsMap;
+    // if not solved, bit n = function n that there was no pin left for.
+    uint64_t conflicts = 0;
+} pinSolution_s;
+
+// Finds a complete pin map for a board by backtracking over bitmasks.
+namespace pinSolver {
+
+// required is a bitmask of boardInputs_e that need a pin; pinned is an inputsMap-style set of choices
+// that stay exactly where they are (and count as required).
+// Only the board's usable pins are handed out, and functions only go where PinFunctionsMask allows.
+// Functions go to their spot in the board's default layout whenever that's still free.
+pinSolution_s Solve(const boardDesc_s &board, uint64_t required, const int8_t *pinned);
+
+}
+
+#endif // PINSOLVER_H
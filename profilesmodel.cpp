@@ -0,0 +1,277 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "profilesmodel.h"
+
+#include <QColor>
+#include <QColorDialog>
+#include <QComboBox>
+#include <QLineEdit>
+
+profilesModel::profilesModel(const QVector<profilesTable_s> &profiles, QObject *parent)
+    : QAbstractTableModel(parent)
+    , profiles(profiles)
+{
+}
+
+
+// Name goes first, everything else keeps the order of profileFields_e.
+uint8_t profilesModel::ColumnField(int column)
+{
+    return column == 0 ? profName : column - 1;
+}
+
+
+int profilesModel::FieldColumn(uint8_t field)
+{
+    return field == profName ? 0 : field + 1;
+}
+
+
+QStringList profilesModel::FieldOptions(uint8_t field)
+{
+    switch(field) {
+    case profIrSensitivity: return {"Default", "Higher", "Highest"};
+    case profRunMode:       return {"Normal", "1-Frame Avg", "2-Frame Avg"};
+    case profLayoutType:    return {"Square", "Diamond"};
+    default:                return {};
+    }
+}
+
+
+int profilesModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : profiles.length();
+}
+
+
+int profilesModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : profileFieldsCount;
+}
+
+
+QVariant profilesModel::data(const QModelIndex &index, int role) const
+{
+    if(!index.isValid() || index.row() >= profiles.length()) {
+        return QVariant();
+    }
+    const profilesTable_s &profile = profiles[index.row()];
+    uint8_t field = ColumnField(index.column());
+
+    uint32_t value = 0;
+    switch(field) {
+    case profTopOffset:     value = profile.topOffset; break;
+    case profBottomOffset:  value = profile.bottomOffset; break;
+    case profLeftOffset:    value = profile.leftOffset; break;
+    case profRightOffset:   value = profile.rightOffset; break;
+    case profTLled:         value = profile.TLled; break;
+    case profTRled:         value = profile.TRled; break;
+    case profIrSensitivity: value = profile.irSensitivity; break;
+    case profRunMode:       value = profile.runMode; break;
+    case profLayoutType:    value = profile.layoutType; break;
+    case profColor:         value = profile.color; break;
+    case profName:
+        switch(role) {
+        case Qt::DisplayRole:
+            return profile.profName.isEmpty() ? QString("%1.").arg(index.row()+1) : profile.profName;
+        case Qt::EditRole:
+            return profile.profName;
+        case Qt::CheckStateRole:
+            return index.row() == selected ? Qt::Checked : Qt::Unchecked;
+        default:
+            return QVariant();
+        }
+    }
+
+    switch(role) {
+    case Qt::DisplayRole: {
+        if(field == profColor) {
+            return QVariant();
+        }
+        QStringList options = FieldOptions(field);
+        return value < uint32_t(options.length()) ? options[value] : QString::number(value);
+    }
+    case Qt::EditRole:
+        return value;
+    case Qt::BackgroundRole:
+        return field == profColor ? QVariant(QColor(QRgb(value))) : QVariant();
+    case Qt::TextAlignmentRole:
+        return int(Qt::AlignCenter);
+    default:
+        return QVariant();
+    }
+}
+
+
+QVariant profilesModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if(role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    if(orientation == Qt::Vertical) {
+        return section + 1;
+    }
+    switch(ColumnField(section)) {
+    case profName:          return "Profile";
+    case profTopOffset:     return "Top";
+    case profBottomOffset:  return "Bottom";
+    case profLeftOffset:    return "Left";
+    case profRightOffset:   return "Right";
+    case profTLled:         return "TLled";
+    case profTRled:         return "TRled";
+    case profIrSensitivity: return "Sensitivity";
+    case profRunMode:       return "Run Mode";
+    case profLayoutType:    return "Layout";
+    case profColor:         return "Color";
+    default:                return QVariant();
+    }
+}
+
+
+Qt::ItemFlags profilesModel::flags(const QModelIndex &index) const
+{
+    if(!index.isValid()) {
+        return Qt::NoItemFlags;
+    }
+    Qt::ItemFlags flags = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+    switch(ColumnField(index.column())) {
+    case profName:
+        flags |= Qt::ItemIsEditable | Qt::ItemIsUserCheckable;
+        break;
+    case profIrSensitivity:
+    case profRunMode:
+    case profLayoutType:
+        flags |= Qt::ItemIsEditable;
+        break;
+    default:
+        // offsets & LED positions only ever come from calibrating,
+        // and the color's picked from a dialog rather than edited in place (see profilesDelegate).
+        break;
+    }
+    return flags;
+}
+
+
+bool profilesModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    uint8_t field = ColumnField(index.column());
+    if(!index.isValid() || !(flags(index).testFlag(Qt::ItemIsEditable) || field == profColor)) {
+        return false;
+    }
+    if(role == Qt::CheckStateRole && field == profName) {
+        // can only pick a profile, not unpick one.
+        if(value.toInt() == Qt::Checked && index.row() != selected) {
+            emit profileSelected(index.row());
+        }
+        return true;
+    } else if(role == Qt::EditRole) {
+        emit fieldEdited(index.row(), field, value);
+        return true;
+    }
+    return false;
+}
+
+
+void profilesModel::Reload(uint8_t selected)
+{
+    beginResetModel();
+    this->selected = selected;
+    endResetModel();
+}
+
+
+void profilesModel::FieldChanged(uint8_t slot, uint8_t field)
+{
+    QModelIndex cell = index(slot, FieldColumn(field));
+    emit dataChanged(cell, cell);
+}
+
+
+void profilesModel::SelectedChanged(uint8_t slot)
+{
+    uint8_t previous = selected;
+    selected = slot;
+    FieldChanged(previous, profName);
+    FieldChanged(slot, profName);
+}
+
+
+profilesDelegate::profilesDelegate(QObject *parent)
+    : QStyledItemDelegate(parent)
+{
+}
+
+
+QWidget *profilesDelegate::createEditor(QWidget *parent, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    uint8_t field = profilesModel::ColumnField(index.column());
+    QStringList options = profilesModel::FieldOptions(field);
+    if(!options.isEmpty()) {
+        QComboBox *box = new QComboBox(parent);
+        box->addItems(options);
+        // picking something is the whole edit, no need to click off of it too.
+        connect(box, QOverload<int>::of(&QComboBox::activated), this, [this, box]() {
+            profilesDelegate *self = const_cast<profilesDelegate*>(this);
+            emit self->commitData(box);
+            emit self->closeEditor(box);
+        });
+        return box;
+    } else if(field == profName) {
+        QLineEdit *edit = new QLineEdit(parent);
+        edit->setMaxLength(PROFILE_NAME_MAX);
+        return edit;
+    }
+    return QStyledItemDelegate::createEditor(parent, option, index);
+}
+
+
+void profilesDelegate::setEditorData(QWidget *editor, const QModelIndex &index) const
+{
+    if(QComboBox *box = qobject_cast<QComboBox*>(editor)) {
+        box->setCurrentIndex(index.data(Qt::EditRole).toInt());
+    } else {
+        QStyledItemDelegate::setEditorData(editor, index);
+    }
+}
+
+
+void profilesDelegate::setModelData(QWidget *editor, QAbstractItemModel *model, const QModelIndex &index) const
+{
+    if(QComboBox *box = qobject_cast<QComboBox*>(editor)) {
+        model->setData(index, box->currentIndex());
+    } else if(QLineEdit *edit = qobject_cast<QLineEdit*>(editor)) {
+        if(!edit->text().isEmpty()) {
+            model->setData(index, edit->text());
+        }
+    } else {
+        QStyledItemDelegate::setModelData(editor, model, index);
+    }
+}
+
+
+bool profilesDelegate::editorEvent(QEvent *event, QAbstractItemModel *model, const QStyleOptionViewItem &option, const QModelIndex &index)
+{
+    if(profilesModel::ColumnField(index.column()) == profColor && event->type() == QEvent::MouseButtonDblClick) {
+        QColor colorPick = QColorDialog::getColor(QColor(QRgb(index.data(Qt::EditRole).toUInt())));
+        if(colorPick.isValid()) {
+            model->setData(index, colorPick.rgb() & 0xFFFFFF);
+        }
+        return true;
+    }
+    return QStyledItemDelegate::editorEvent(event, model, option, index);
+}
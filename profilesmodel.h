@@ -0,0 +1,92 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef PROFILESMODEL_H
+#define PROFILESMODEL_H
+
+#include "constants.h"
+#include "configdiff.h"
+#include <QAbstractTableModel>
+#include <QStyledItemDelegate>
+
+// Table model over the calibration profiles, one row per profile the gun reports.
+// Columns are the profile's name (checked = the active profile), then the rest of profileFields_e in order.
+// Edits don't go straight into the table - they come out of fieldEdited()/profileSelected() so
+// the window can run them through its setters, which then call FieldChanged() to redraw just that cell.
+class profilesModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    profilesModel(const QVector<profilesTable_s> &profiles, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+
+    // Whole table changed underneath (new gun, different amount of profiles).
+    void Reload(uint8_t selected);
+
+    void FieldChanged(uint8_t slot, uint8_t field);
+
+    void SelectedChanged(uint8_t slot);
+
+    static uint8_t ColumnField(int column);
+
+    static int FieldColumn(uint8_t field);
+
+    // Names for the values of the fields picked from a list (IR sensitivity, run mode, layout); empty for the rest.
+    static QStringList FieldOptions(uint8_t field);
+
+signals:
+    void fieldEdited(uint8_t slot, uint8_t field, const QVariant &value);
+
+    void profileSelected(uint8_t slot);
+
+private:
+    const QVector<profilesTable_s> &profiles;
+
+    uint8_t selected = 0;
+};
+
+// Editors for the above: a dropdown for the list fields, a color picker for the color,
+// and a 15 character line edit for the name.
+class profilesDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    profilesDelegate(QObject *parent = nullptr);
+
+    QWidget *createEditor(QWidget *parent, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+
+    void setEditorData(QWidget *editor, const QModelIndex &index) const override;
+
+    void setModelData(QWidget *editor, QAbstractItemModel *model, const QModelIndex &index) const override;
+
+    bool editorEvent(QEvent *event, QAbstractItemModel *model, const QStyleOptionViewItem &option, const QModelIndex &index) override;
+};
+
+#endif // PROFILESMODEL_H
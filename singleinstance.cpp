@@ -0,0 +1,93 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "singleinstance.h"
+#include "constants.h"
+#include <QDataStream>
+#include <QLocalSocket>
+#include <QtDebug>
+
+singleInstance::singleInstance(QObject *parent)
+    : QObject(parent)
+{
+    // Per-user, so two people logged into the same cabinet don't hand off to each other.
+#ifdef Q_OS_WIN
+    serverName = QString("%1-%2").arg(INSTANCE_NAME, qEnvironmentVariable("USERNAME"));
+#else
+    serverName = QString("%1-%2").arg(INSTANCE_NAME, qEnvironmentVariable("USER"));
+#endif
+    connect(&server, &QLocalServer::newConnection, this, &singleInstance::server_newConnection);
+}
+
+bool singleInstance::HandOff(const QStringList &args)
+{
+    QLocalSocket socket;
+    socket.connectToServer(serverName);
+    if(!socket.waitForConnected(INSTANCE_TIMEOUT)) {
+        return false;
+    }
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream << args;
+    socket.write(payload);
+    if(!socket.waitForBytesWritten(INSTANCE_TIMEOUT)) {
+        // the other instance is wedged; better to start up than to do nothing.
+        return false;
+    }
+    socket.disconnectFromServer();
+    qDebug() << "Handed arguments off to the running instance.";
+    return true;
+}
+
+bool singleInstance::Listen()
+{
+    server.setSocketOptions(QLocalServer::UserAccessOption);
+    if(!server.listen(serverName)) {
+        // a crashed instance can leave its socket behind, so clear it out and retry once;
+        // but only if nobody answers on it, else a busy instance would lose its socket to us.
+        QLocalSocket probe;
+        probe.connectToServer(serverName);
+        if(probe.waitForConnected(INSTANCE_TIMEOUT)) {
+            probe.abort();
+            qDebug() << "Another instance is listening, not taking over its socket.";
+            return false;
+        }
+        QLocalServer::removeServer(serverName);
+        return server.listen(serverName);
+    }
+    return true;
+}
+
+void singleInstance::server_newConnection()
+{
+    while(server.hasPendingConnections()) {
+        QLocalSocket *client = server.nextPendingConnection();
+        // the whole command line arrives at once and the sender hangs up right after.
+        connect(client, &QLocalSocket::disconnected, this, [this, client]() {
+            QByteArray payload = client->readAll();
+            client->deleteLater();
+            // a later launch only checking whether we're here (see Listen()) hangs up without sending anything.
+            if(payload.isEmpty()) {
+                return;
+            }
+            QDataStream stream(payload);
+            QStringList args;
+            stream >> args;
+            emit argumentsReceived(args);
+        });
+    }
+}
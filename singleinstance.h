@@ -0,0 +1,52 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef SINGLEINSTANCE_H
+#define SINGLEINSTANCE_H
+
+#include <QObject>
+#include <QLocalServer>
+#include <QStringList>
+
+// Keeps the app to one window per user. The first instance listens on a local socket;
+// any later launch forwards its command line there and quits before building a window.
+class singleInstance : public QObject
+{
+    Q_OBJECT
+
+public:
+    singleInstance(QObject *parent = nullptr);
+
+    // Returns true if another instance took the arguments, i.e. this one should exit now.
+    bool HandOff(const QStringList &args);
+
+    // Start accepting hand-offs from later launches.
+    bool Listen();
+
+signals:
+    void argumentsReceived(const QStringList &args);
+
+private slots:
+    void server_newConnection();
+
+private:
+    QLocalServer server;
+
+    QString serverName;
+};
+
+#endif // SINGLEINSTANCE_H
@@ -0,0 +1,55 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "startupprofile.h"
+
+#include <QElapsedTimer>
+#include <cstdio>
+
+static QElapsedTimer startupTimer;
+static qint64 lastMark = 0;
+static bool profiling = false;
+
+void startupProfile::Begin(bool enabled)
+{
+    profiling = enabled;
+    lastMark = 0;
+    startupTimer.start();
+    if(profiling) {
+        fprintf(stderr, "%-28s %10s %10s\n", "Startup phase", "Took (ms)", "Total (ms)");
+    }
+}
+
+
+bool startupProfile::Enabled()
+{
+    return profiling;
+}
+
+
+void startupProfile::Mark(const char *phase)
+{
+    if(!profiling) {
+        return;
+    }
+
+    // nsecs, since most phases are well under a millisecond.
+    qint64 now = startupTimer.nsecsElapsed();
+    fprintf(stderr, "%-28s %10.2f %10.2f\n", phase, (now - lastMark) / 1e6, now / 1e6);
+    fflush(stderr);
+    lastMark = now;
+}
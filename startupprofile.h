@@ -0,0 +1,36 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef STARTUPPROFILE_H
+#define STARTUPPROFILE_H
+
+// Phase-by-phase timing of the way up to a usable window, for --startup-profile.
+// Every Mark() prints how long that phase took and the running total on stderr;
+// when profiling is off they do nothing, so they can be left sprinkled around.
+namespace startupProfile {
+
+// Starts the clock; call as early in main() as possible.
+void Begin(bool enabled);
+
+bool Enabled();
+
+// Ends the current phase, named after what just finished.
+void Mark(const char *phase);
+
+}
+
+#endif // STARTUPPROFILE_H
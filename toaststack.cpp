@@ -0,0 +1,122 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "toaststack.h"
+#include "constants.h"
+#include <QEvent>
+#include <QTimer>
+
+// Most toasts up at once; the oldest one goes to make room.
+#define TOASTS_MAX 4
+
+#define TOAST_WIDTH 360
+#define TOAST_MARGIN 12
+
+// Styles are made once per severity, so showing a toast never builds a stylesheet.
+static const char *const toastStyles[] = {
+    "QLabel { background: #303030; color: white; border-radius: 6px; padding: 8px; }",
+    "QLabel { background: #1c4f82; color: white; border-radius: 6px; padding: 8px; }",
+    "QLabel { background: #1c4f82; color: white; border-radius: 6px; padding: 8px; }",
+    "QLabel { background: #8a5a00; color: white; border-radius: 6px; padding: 8px; }",
+    "QLabel { background: #8b1a1a; color: white; border-radius: 6px; padding: 8px; }"
+};
+
+// How long (in ms) each severity stays up; 0 = until clicked.
+static const int toastTimeouts[] = { 4000, 8000, 8000, 10000, 0 };
+
+toastStack::toastStack(QWidget *window)
+    : QObject(window), window(window)
+{
+    window->installEventFilter(this);
+}
+
+
+void toastStack::Show(const QString &title, const QString &message, uint8_t severity)
+{
+    if(severity > notifyError) {
+        severity = notifyError;
+    }
+
+    toasts.removeAll(QPointer<QLabel>());
+    while(toasts.length() >= TOASTS_MAX) {
+        Dismiss(toasts.takeFirst());
+    }
+
+    QLabel *toast = new QLabel(window);
+    toast->setTextFormat(Qt::RichText);
+    toast->setWordWrap(true);
+    toast->setFixedWidth(TOAST_WIDTH);
+    toast->setStyleSheet(toastStyles[severity]);
+    toast->setToolTip("Click to dismiss");
+    QString body = message.toHtmlEscaped();
+    body.replace('\n', "<br>");
+    toast->setText(QString("<b>%1</b><br>%2").arg(title.toHtmlEscaped(), body));
+    toast->adjustSize();
+    toast->installEventFilter(this);
+    toasts.append(toast);
+    if(toastTimeouts[severity]) {
+        QPointer<QLabel> expiring = toast;
+        QTimer::singleShot(toastTimeouts[severity], this, [this, expiring]() {
+            if(expiring) {
+                Dismiss(expiring);
+            }
+        });
+    }
+    Reposition();
+    toast->show();
+    toast->raise();
+}
+
+
+bool toastStack::eventFilter(QObject *watched, QEvent *event)
+{
+    if(watched == window) {
+        if(event->type() == QEvent::Resize) {
+            Reposition();
+        }
+    } else if(event->type() == QEvent::MouseButtonRelease) {
+        Dismiss(qobject_cast<QLabel*>(watched));
+        return true;
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+
+void toastStack::Dismiss(QLabel *toast)
+{
+    if(!toast) {
+        return;
+    }
+    toasts.removeAll(toast);
+    toast->hide();
+    toast->deleteLater();
+    Reposition();
+}
+
+
+void toastStack::Reposition()
+{
+    int bottom = window->height() - TOAST_MARGIN;
+    for(int i = toasts.length() - 1; i >= 0; --i) {
+        if(!toasts[i]) {
+            continue;
+        }
+        bottom -= toasts[i]->height();
+        toasts[i]->move(window->width() - TOAST_WIDTH - TOAST_MARGIN, bottom);
+        bottom -= TOAST_MARGIN / 2;
+    }
+}
@@ -0,0 +1,53 @@
+/*  OpenFIRE App: a configuration utility for the OpenFIRE light gun system.
+    Copyright (C) 2024  Team OpenFIRE
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TOASTSTACK_H
+#define TOASTSTACK_H
+
+#include <QLabel>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+
+// Non-modal notices, stacked up in the bottom right corner of a window with the newest at the bottom.
+// Nothing here waits on the user, so serial work carries on while they're up.
+// Errors stay until clicked; everything else also goes away on its own after a bit.
+class toastStack : public QObject
+{
+    Q_OBJECT
+
+public:
+    toastStack(QWidget *window);
+
+    // severity is a notifySeverity_e
+    void Show(const QString &title, const QString &message, uint8_t severity);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    QWidget *window;
+
+    // oldest first; entries go null as toasts are dismissed.
+    QList<QPointer<QLabel>> toasts;
+
+    void Dismiss(QLabel *toast);
+
+    void Reposition();
+};
+
+#endif // TOASTSTACK_H